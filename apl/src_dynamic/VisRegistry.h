@@ -22,6 +22,28 @@ class RegistryDynamic : public RegistryBase {
 private:
     std::unordered_map<std::string, void*> m_storage;  // string→void* storage
 
+    // Type-erased side index of bindings that derive from Field_b / ParticleBase_b,
+    // so generic consumers (derived fields, exporters) can walk them without the concrete type.
+    std::unordered_map<std::string, Field_b*> m_fields;
+    std::unordered_map<std::string, ParticleBase_b*> m_particles;
+
+    template<typename U>
+    void index_binding(const std::string& key, U& object) {
+        m_fields.erase(key);
+        m_particles.erase(key);
+        using V = std::remove_const_t<U>;
+        if constexpr (std::is_base_of_v<Field_b, V>) {
+            m_fields[key] = const_cast<V*>(&object);
+        } else if constexpr (std::is_base_of_v<ParticleBase_b, V>) {
+            m_particles[key] = const_cast<V*>(&object);
+        }
+    }
+
+    void unindex_binding(const std::string& key) {
+        m_fields.erase(key);
+        m_particles.erase(key);
+    }
+
 public:
     // Quick check whether the registry has any bindings
     bool empty() const noexcept { return m_storage.empty(); }
@@ -37,6 +59,7 @@ public:
     {
         std::string key{ Name.sv() };
         m_storage[key] = const_cast<void*>(static_cast<const void*>(&object));
+        index_binding(key, object);
     }
 
     // Get with compile-time name (SFINAE ensures known name)
@@ -85,6 +108,7 @@ public:
         !std::is_same_v<typename NameToType<Name>::type, void>, bool>
     {
         std::string key{ Name.sv() };
+        unindex_binding(key);
         return m_storage.erase(key) > 0;
     }
 
@@ -116,6 +140,7 @@ public:
     template<typename T>
     void set_named(const std::string& name, T& object) {
         m_storage[name] = const_cast<void*>(static_cast<const void*>(&object));
+        index_binding(name, object);
     }
 
     template<typename T>
@@ -129,8 +154,32 @@ public:
     }
 
     bool unset_named(const std::string& name) {
+        unindex_binding(name);
         return m_storage.erase(name) > 0;
     }
+
+    // Type-erased access to bound fields / particle containers (nullptr if absent or not one)
+    Field_b* find_field(const std::string& name) const {
+        auto it = m_fields.find(name);
+        return it != m_fields.end() ? it->second : nullptr;
+    }
+
+    ParticleBase_b* find_particles(const std::string& name) const {
+        auto it = m_particles.find(name);
+        return it != m_particles.end() ? it->second : nullptr;
+    }
+
+    // fn(const std::string& name, Field_b&) for every bound field
+    template<typename Fn>
+    void for_each_field(Fn&& fn) const {
+        for (const auto& [name, f] : m_fields) fn(name, *f);
+    }
+
+    // fn(const std::string& name, ParticleBase_b&) for every bound particle container
+    template<typename Fn>
+    void for_each_particles(Fn&& fn) const {
+        for (const auto& [name, p] : m_particles) fn(name, *p);
+    }
 };
 
 // Macro to register name→type for this handler (must be at namespace scope)
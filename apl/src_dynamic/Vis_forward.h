@@ -4,6 +4,7 @@
 #include <any>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 
 
 #include <cassert>
@@ -253,6 +254,10 @@ class VisRegistry ;
 template<typename T, unsigned Dim>
 class ParticleBase;
 
+class ParticleBase_b;
+
+class Field_b;
+
 template<typename T, unsigned Dim>
 class Field;
 
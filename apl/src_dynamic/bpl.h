@@ -7,5 +7,19 @@
 #include "particle.h"
 #include "field.h"
 
+#include "reduce.h"
+#include "expr.h"
+#include "derived.h"
+#include "snapshot.h"
+#include "schema.h"
+#include "particles_soa.h"
+#include "grid_field.h"
+#include "shape.h"
+#include "deposit.h"
+#include "gather.h"
+#include "decimate.h"
+#include "halo.h"
+#include "migrate.h"
+
 
 
@@ -0,0 +1,517 @@
+#pragma once
+#include "bpl.h"
+
+#include <catalyst_conduit.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+
+// Registry -> Conduit bridge: publishes every bound Field / particle container of a
+// RegistryDynamic as a Blueprint field, zero-copy.
+//
+// - Each binding is described with describe() (descriptor.h) and referenced with
+//   set_external using its dtype; nothing is copied. The memory must stay alive and
+//   unmoved until catalyst_execute returns (the usual Catalyst contract).
+// - Scalars become fields/<name>/values. vec<S,N> (AoS) becomes an mcarray values/x,y,z,w
+//   (c0, c1, ... for N > 4): every component points into the same storage with byte offset
+//   c * component_stride and the element stride, so the interleaved layout is kept.
+// - Fields go to `topology` with `association`, particle containers to
+//   `particle_topology` as vertex fields. The bridge does not build meshes; the caller
+//   provides coordsets/topologies whose sizes match.
+// - Selection is a runtime list of patterns: "E,rho" publishes only those, "p_*" matches
+//   a prefix, "!name" excludes, empty or "*" selects everything.
+// - Exception: a CowField (snapshot.h) spanning several chunks has no single array. It is
+//   published as a contiguous copy of a snapshot, owned by the bridge and refreshed on
+//   every publish (Stats::copied).
+//
+// Nodes are created on the first publish and kept as conduit_node handles, like
+// PersistentChannel in the mini apps: later steps only re-point the external arrays.
+// A binding whose layout (dtype, components, count) changes is rebuilt, one that is no
+// longer bound is removed; both bump schema_version(). The registry holds raw pointers,
+// so a binding must be unset before its object is destroyed.
+
+// Runtime configuration, e.g. from the environment or Catalyst parameters.
+struct ConduitBridgeOptions {
+    std::string channel = "grid";
+    std::string topology = "mesh";
+    std::string association = "element";
+    std::string particle_topology = "particles";
+    std::vector<std::string> select;   // patterns; empty: all bindings
+
+    // APL_CONDUIT_CHANNEL, APL_CONDUIT_TOPOLOGY, APL_CONDUIT_ASSOCIATION,
+    // APL_CONDUIT_PARTICLE_TOPOLOGY, APL_CONDUIT_SELECT (comma separated)
+    static ConduitBridgeOptions from_env() {
+        ConduitBridgeOptions o;
+        if (const char* v = std::getenv("APL_CONDUIT_CHANNEL")) o.channel = v;
+        if (const char* v = std::getenv("APL_CONDUIT_TOPOLOGY")) o.topology = v;
+        if (const char* v = std::getenv("APL_CONDUIT_ASSOCIATION")) o.association = v;
+        if (const char* v = std::getenv("APL_CONDUIT_PARTICLE_TOPOLOGY")) o.particle_topology = v;
+        if (const char* v = std::getenv("APL_CONDUIT_SELECT")) o.select = split_list(v);
+        return o;
+    }
+
+    static std::vector<std::string> split_list(const std::string& s) {
+        std::vector<std::string> out;
+        std::stringstream ss(s);
+        std::string tok;
+        while (std::getline(ss, tok, ',')) {
+            if (!tok.empty()) out.push_back(tok);
+        }
+        return out;
+    }
+};
+
+// Reference one component (byte offset `offset`) of every element of `d` with set_external.
+inline void conduit_set_external(conduit_cpp::Node node, const DataDescriptor& d, std::int64_t offset = 0) {
+    const conduit_index_t n = d.num_elements();
+    const conduit_index_t stride = d.ndim ? d.strides[0] : static_cast<std::int64_t>(d.element_bytes());
+    switch (d.dtype) {
+        case DType::Int8: node.set_external(static_cast<conduit_int8*>(d.data), n, offset, stride); return;
+        case DType::Int16: node.set_external(static_cast<conduit_int16*>(d.data), n, offset, stride); return;
+        case DType::Int32: node.set_external(static_cast<conduit_int32*>(d.data), n, offset, stride); return;
+        case DType::Int64: node.set_external(static_cast<conduit_int64*>(d.data), n, offset, stride); return;
+        case DType::UInt8: node.set_external(static_cast<conduit_uint8*>(d.data), n, offset, stride); return;
+        case DType::UInt16: node.set_external(static_cast<conduit_uint16*>(d.data), n, offset, stride); return;
+        case DType::UInt32: node.set_external(static_cast<conduit_uint32*>(d.data), n, offset, stride); return;
+        case DType::UInt64: node.set_external(static_cast<conduit_uint64*>(d.data), n, offset, stride); return;
+        case DType::Float32: node.set_external(static_cast<conduit_float32*>(d.data), n, offset, stride); return;
+        case DType::Float64: node.set_external(static_cast<conduit_float64*>(d.data), n, offset, stride); return;
+    }
+    throw std::invalid_argument("conduit_set_external: unknown dtype");
+}
+
+// Blueprint mcarray component name (schema.h naming).
+inline std::string conduit_component_name(unsigned c, unsigned components) {
+    char buf[16]{};
+    return std::string(buf, schema_component_name(c, std::max(components, 2u), buf));
+}
+
+// Conduit type id of a DType.
+constexpr conduit_index_t conduit_dtype_id(DType t) {
+    switch (t) {
+        case DType::Int8: return CONDUIT_INT8_ID;
+        case DType::Int16: return CONDUIT_INT16_ID;
+        case DType::Int32: return CONDUIT_INT32_ID;
+        case DType::Int64: return CONDUIT_INT64_ID;
+        case DType::UInt8: return CONDUIT_UINT8_ID;
+        case DType::UInt16: return CONDUIT_UINT16_ID;
+        case DType::UInt32: return CONDUIT_UINT32_ID;
+        case DType::UInt64: return CONDUIT_UINT64_ID;
+        case DType::Float32: return CONDUIT_FLOAT32_ID;
+        case DType::Float64: return CONDUIT_FLOAT64_ID;
+    }
+    return CONDUIT_EMPTY_ID;
+}
+
+class ConduitBridge {
+public:
+    struct Stats {
+        std::size_t bindings = 0;   // fields + particle containers published
+        std::size_t arrays = 0;     // external arrays (one per component)
+        std::size_t bytes = 0;      // referenced, not copied
+        std::size_t copied = 0;     // bytes copied for chunked CowFields
+        bool schema_changed = false;
+    };
+
+    explicit ConduitBridge(ConduitBridgeOptions options = ConduitBridgeOptions::from_env())
+        : m_opts(std::move(options)) {}
+
+    const ConduitBridgeOptions& options() const { return m_opts; }
+    const std::string& channel() const { return m_opts.channel; }
+
+    // Change the selection at runtime; deselected bindings are removed on the next publish.
+    void select(std::vector<std::string> patterns) { m_opts.select = std::move(patterns); }
+
+    bool selected(const std::string& name) const {
+        bool any_include = false, included = false;
+        for (const auto& p : m_opts.select) {
+            if (!p.empty() && p[0] == '!') {
+                if (matches(p.substr(1), name)) return false;
+                continue;
+            }
+            any_include = true;
+            included = included || matches(p, name);
+        }
+        return !any_include || included;
+    }
+
+    // Bumped whenever a field node is created, rebuilt or removed (re-verify the mesh then).
+    std::uint64_t schema_version() const { return m_schema; }
+
+    // Publish all selected bindings of `reg` into `data` (the channel's "data" node).
+    // `data` must be the same node on every call.
+    template <typename Registry>
+    Stats publish(const Registry& reg, conduit_cpp::Node data) {
+        Stats s;
+        for (auto& [name, e] : m_entries) e.seen = false;
+
+        reg.for_each_field([&](const std::string& name, const Field_b& f) {
+            if (!selected(name)) return;
+            if (const auto* cow = dynamic_cast<const Snapshottable*>(&f)) {
+                const auto snap = cow->snapshot_erased();
+                if (snap->num_chunks() == 0) return;   // empty: removed like an unbound name
+                if (snap->num_chunks() > 1) {
+                    publish_one(data, name, compact(name, *snap, s), m_opts.topology, m_opts.association, s);
+                    return;
+                }
+            }
+            publish_one(data, name, f.describe(), m_opts.topology, m_opts.association, s);
+        });
+        reg.for_each_particles([&](const std::string& name, const ParticleBase_b& p) {
+            if (selected(name)) publish_one(data, name, p.describe(), m_opts.particle_topology, "vertex", s);
+        });
+
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->second.seen) { ++it; continue; }
+            conduit_cpp::Node fields = data["fields"];
+            fields.remove(it->first);
+            m_copies.erase(it->first);
+            it = m_entries.erase(it);
+            ++m_schema;
+            s.schema_changed = true;
+        }
+        // an empty "fields" object is not a valid Blueprint mesh
+        if (m_entries.empty() && data.has_path("fields")) data.remove("fields");
+        return s;
+    }
+
+    // Convenience: publish into catalyst/channels/<channel>/data of an execute node.
+    template <typename Registry>
+    Stats publish_exec(const Registry& reg, conduit_cpp::Node exec) {
+        conduit_cpp::Node ch = exec["catalyst/channels/" + m_opts.channel];
+        if (!ch.has_path("type")) ch["type"].set("mesh");
+        return publish(reg, ch["data"]);
+    }
+
+private:
+    struct Entry {
+        DType dtype = DType::Float64;
+        unsigned components = 0;
+        std::int64_t count = -1;
+        std::vector<conduit_node*> values;   // one per component
+        bool seen = false;
+    };
+
+    static bool matches(const std::string& pattern, const std::string& name) {
+        if (pattern == "*") return true;
+        if (!pattern.empty() && pattern.back() == '*') {
+            return name.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+        }
+        return pattern == name;
+    }
+
+    // One strided 1D view over all axes (axis 0 fastest) or throw.
+    static DataDescriptor flatten(const DataDescriptor& d, const std::string& name) {
+        DataDescriptor f = d;
+        for (unsigned a = 1; a < d.ndim; ++a) {
+            if (d.strides[a] != d.strides[a - 1] * d.extents[a - 1]) {
+                throw std::invalid_argument("ConduitBridge: '" + name +
+                                            "' is not expressible as one strided array");
+            }
+        }
+        f.ndim = 1;
+        f.extents[0] = d.num_elements();
+        f.strides[0] = d.ndim ? d.strides[0] : static_cast<std::int64_t>(d.element_bytes());
+        return f;
+    }
+
+    static conduit_node* handle(conduit_cpp::Node n) { return conduit_cpp::c_node(&n); }
+
+    // Chunks of a snapshot copied into one buffer kept per name; a 1D contiguous view of it.
+    DataDescriptor compact(const std::string& name, const FieldSnapshotBase& snap, Stats& s) {
+        DataDescriptor d = snap.describe_chunk(0);
+        const std::size_t eb = d.element_bytes();
+        std::size_t bytes = 0;
+        for (std::size_t c = 0; c < snap.num_chunks(); ++c) {
+            bytes += static_cast<std::size_t>(snap.describe_chunk(c).num_elements()) * eb;
+        }
+        auto& buf = m_copies[name];
+        if (!buf || buf->size() != bytes) buf = std::make_shared<std::vector<std::byte>>(bytes);
+        std::size_t off = 0;
+        for (std::size_t c = 0; c < snap.num_chunks(); ++c) {
+            const DataDescriptor part = snap.describe_chunk(c);
+            const std::size_t n = static_cast<std::size_t>(part.num_elements()) * eb;
+            std::memcpy(buf->data() + off, part.data, n);
+            off += n;
+        }
+        s.copied += bytes;
+        d.data = buf->data();
+        d.ndim = 1;
+        d.extents[0] = static_cast<std::int64_t>(bytes / eb);
+        d.strides[0] = static_cast<std::int64_t>(eb);
+        d.keepalive = buf;
+        d.owner.reset();
+        return d;
+    }
+
+    void publish_one(conduit_cpp::Node data, const std::string& name, const DataDescriptor& raw,
+                     const std::string& topology, const std::string& association, Stats& s) {
+        if (!raw.valid()) return;  // no storage: dropped below like an unbound name
+        const DataDescriptor d = flatten(raw, name);
+
+        Entry& e = m_entries[name];
+        e.seen = true;
+        if (e.dtype != d.dtype || e.components != d.components || e.count != d.extents[0]) {
+            conduit_cpp::Node fld = data["fields/" + name];
+            fld.reset();
+            fld["association"].set(association);
+            fld["topology"].set(topology);
+            e.values.clear();
+            if (d.components == 1) {
+                e.values.push_back(handle(fld["values"]));
+            } else {
+                for (unsigned c = 0; c < d.components; ++c) {
+                    e.values.push_back(handle(fld["values/" + conduit_component_name(c, d.components)]));
+                }
+            }
+            e.dtype = d.dtype;
+            e.components = d.components;
+            e.count = d.extents[0];
+            ++m_schema;
+            s.schema_changed = true;
+        }
+
+        for (unsigned c = 0; c < d.components; ++c) {
+            conduit_set_external(conduit_cpp::cpp_node(e.values[c]), d,
+                                 static_cast<std::int64_t>(c) * d.component_stride);
+        }
+        ++s.bindings;
+        s.arrays += d.components;
+        s.bytes += static_cast<std::size_t>(d.num_values()) * dtype_size(d.dtype);
+    }
+
+    ConduitBridgeOptions m_opts;
+    std::map<std::string, Entry> m_entries;
+    std::map<std::string, std::shared_ptr<std::vector<std::byte>>> m_copies;   // chunked CowFields
+    std::uint64_t m_schema = 0;
+};
+
+
+// Compile-time counterpart of ConduitBridge for a fixed set of registry IDs.
+// Paths, component names, dtypes, counts and strides come from ContainerSchema
+// (schema.h); the constructor creates the nodes once from the constexpr paths and keeps
+// one handle per component, bind() resolves the typed objects once. publish() then only
+// re-points the handles: no registry lookup, no string building, no type dispatch.
+//
+//   ConduitSchemaBinding<"E", "rho"> schema(data);  // after the mesh
+//   schema.bind(reg);                               // again after rebinding an ID
+//   schema.publish();                               // every step
+template <fixed_string... Ids>
+class ConduitSchemaBinding {
+    template <fixed_string Id>
+    using container_t = typename RegistryDynamic::NameToType<Id>::type;
+
+    using Objects = std::tuple<const container_t<Ids>*...>;
+    static constexpr std::size_t num_arrays = (std::size_t{0} + ... + ContainerSchema<container_t<Ids>>::components);
+
+    std::array<conduit_node*, num_arrays> m_values{};
+    Objects m_objects{};
+
+public:
+    static_assert(sizeof...(Ids) > 0, "ConduitSchemaBinding: no IDs");
+    static_assert((!std::is_void_v<container_t<Ids>> && ...), "ConduitSchemaBinding: ID not registered");
+
+    explicit ConduitSchemaBinding(conduit_cpp::Node data, const std::string& topology = "mesh",
+                                  const std::string& association = "element",
+                                  const std::string& particle_topology = "particles") {
+        std::size_t h = 0;
+        (create<Ids>(data, topology, association, particle_topology, h), ...);
+    }
+
+    // Resolve the bound objects (throws if an ID is not bound).
+    void bind(const RegistryDynamic& reg) {
+        m_objects = Objects{&reg.template Get<Ids>()...};
+    }
+
+    bool bound() const {
+        return std::apply([](const auto*... p) { return ((p != nullptr) && ...); }, m_objects);
+    }
+
+    void publish() const {
+        if (!bound()) throw std::logic_error("ConduitSchemaBinding: publish() before bind()");
+        publish_all(std::make_index_sequence<sizeof...(Ids)>{});
+    }
+
+    // True if every value node carries the schema's dtype id and element count.
+    bool conforms() const {
+        bool ok = true;
+        std::size_t h = 0;
+        (check<container_t<Ids>>(h, ok), ...);
+        return ok;
+    }
+
+    static constexpr std::size_t arrays() { return num_arrays; }
+
+private:
+    static conduit_node* handle(conduit_cpp::Node n) { return conduit_cpp::c_node(&n); }
+
+    template <fixed_string Id>
+    void create(conduit_cpp::Node data, const std::string& topology, const std::string& association,
+                const std::string& particle_topology, std::size_t& h) {
+        using S = ContainerSchema<container_t<Id>>;
+        conduit_cpp::Node fld = data[schema_field_path<Id>::value.c_str()];
+        fld["association"].set(S::particles ? "vertex" : association);
+        fld["topology"].set(S::particles ? particle_topology : topology);
+        create_values<Id>(data, h, std::make_integer_sequence<unsigned, S::components>{});
+    }
+
+    template <fixed_string Id, unsigned... C>
+    void create_values(conduit_cpp::Node data, std::size_t& h, std::integer_sequence<unsigned, C...>) {
+        ((m_values[h++] = handle(data[schema_value_path<Id, container_t<Id>, C>::value.c_str()])), ...);
+    }
+
+    template <std::size_t... I>
+    void publish_all(std::index_sequence<I...>) const {
+        std::size_t h = 0;
+        (publish_one(std::get<I>(m_objects), h), ...);
+    }
+
+    template <typename Container>
+    void publish_one(const Container* obj, std::size_t& h) const {
+        using S = ContainerSchema<Container>;
+        using P = std::remove_const_t<typename S::scalar_type>;
+        auto* base = const_cast<P*>(reinterpret_cast<const P*>(obj->data.data()));
+        for (unsigned c = 0; c < S::components; ++c) {
+            conduit_cpp::cpp_node(m_values[h++]).set_external(base, S::count, c * S::component_stride,
+                                                                S::element_stride);
+        }
+    }
+
+    template <typename Container>
+    void check(std::size_t& h, bool& ok) const {
+        using S = ContainerSchema<Container>;
+        for (unsigned c = 0; c < S::components; ++c) {
+            conduit_cpp::Node n = conduit_cpp::cpp_node(m_values[h++]);
+            ok = ok && n.dtype().id() == conduit_dtype_id(S::dtype) && n.dtype().number_of_elements() == S::count;
+        }
+    }
+};
+
+
+// Blueprint point mesh of a ParticleSoA (any container with num_columns()/column()/
+// describe_column(), column 0 = positions):
+//   coordsets/<coordset>   explicit, x/y/z referencing the position components
+//   topologies/<topology>  unstructured, elements/shape "point", connectivity 0..n-1
+//   fields/<column>        one vertex field per attribute column (mcarray if vector)
+// All arrays are external. Handles are resolved on the first publish and re-pointed on
+// later ones; the connectivity is owned here (int32 while the count fits) and only
+// regenerated when the count grows past it. publish() returns true when nodes were
+// created (first call or a different column layout).
+class ConduitPointMesh {
+public:
+    explicit ConduitPointMesh(conduit_cpp::Node data, std::string coordset = "particle_coords",
+                              std::string topology = "particles")
+        : m_data(handle(data)), m_coordset(std::move(coordset)), m_topology(std::move(topology)) {}
+
+    template <typename Particles>
+    bool publish(const Particles& p) {
+        const bool rebuilt = layout_changed(p);
+        if (rebuilt) build(p);
+
+        std::size_t h = 0;
+        for (std::size_t c = 0; c < p.num_columns(); ++c) {
+            const DataDescriptor d = p.describe_column(c);
+            for (unsigned k = 0; k < d.components; ++k) {
+                conduit_set_external(conduit_cpp::cpp_node(m_values[h++]), d,
+                                     static_cast<std::int64_t>(k) * d.component_stride);
+            }
+        }
+        publish_connectivity(static_cast<std::int64_t>(p.size()));
+        return rebuilt;
+    }
+
+    // Bytes of the owned connectivity array.
+    std::size_t connectivity_bytes() const {
+        return m_conn32.size() * sizeof(std::int32_t) + m_conn64.size() * sizeof(std::int64_t);
+    }
+
+private:
+    static conduit_node* handle(conduit_cpp::Node n) { return conduit_cpp::c_node(&n); }
+
+    template <typename Particles>
+    bool layout_changed(const Particles& p) const {
+        if (m_layout.size() != p.num_columns()) return true;
+        for (std::size_t c = 0; c < p.num_columns(); ++c) {
+            const auto& col = p.column(c);
+            if (m_layout[c].first != col.name || m_layout[c].second != col.components) return true;
+        }
+        return false;
+    }
+
+    template <typename Particles>
+    void build(const Particles& p) {
+        conduit_cpp::Node data = conduit_cpp::cpp_node(m_data);
+        for (std::size_t c = 1; c < m_layout.size(); ++c) data["fields"].remove(m_layout[c].first);
+        m_layout.clear();
+        m_values.clear();
+
+        conduit_cpp::Node coords = data["coordsets/" + m_coordset];
+        coords.reset();
+        coords["type"].set("explicit");
+        const auto& pos = p.column(0);
+        for (unsigned k = 0; k < pos.components; ++k) {
+            m_values.push_back(handle(coords["values/" + conduit_component_name(k, std::max(pos.components, 2u))]));
+        }
+        m_layout.emplace_back(pos.name, pos.components);
+
+        conduit_cpp::Node topo = data["topologies/" + m_topology];
+        topo.reset();
+        topo["type"].set("unstructured");
+        topo["coordset"].set(m_coordset);
+        topo["elements/shape"].set("point");
+        m_connectivity = handle(topo["elements/connectivity"]);
+
+        for (std::size_t c = 1; c < p.num_columns(); ++c) {
+            const auto& col = p.column(c);
+            conduit_cpp::Node fld = data["fields/" + col.name];
+            fld.reset();
+            fld["association"].set("vertex");
+            fld["topology"].set(m_topology);
+            if (col.components == 1) {
+                m_values.push_back(handle(fld["values"]));
+            } else {
+                for (unsigned k = 0; k < col.components; ++k) {
+                    m_values.push_back(handle(fld["values/" + conduit_component_name(k, col.components)]));
+                }
+            }
+            m_layout.emplace_back(col.name, col.components);
+        }
+    }
+
+    void publish_connectivity(std::int64_t n) {
+        conduit_cpp::Node conn = conduit_cpp::cpp_node(m_connectivity);
+        if (n <= std::numeric_limits<std::int32_t>::max()) {
+            if (static_cast<std::int64_t>(m_conn32.size()) < n) {
+                m_conn64.clear();
+                m_conn64.shrink_to_fit();
+                const std::size_t old = m_conn32.size();
+                m_conn32.resize(static_cast<std::size_t>(n));
+                for (std::size_t i = old; i < m_conn32.size(); ++i) m_conn32[i] = static_cast<std::int32_t>(i);
+            }
+            conn.set_external(m_conn32.data(), n);
+        } else {
+            if (static_cast<std::int64_t>(m_conn64.size()) < n) {
+                m_conn32.clear();
+                m_conn32.shrink_to_fit();
+                const std::size_t old = m_conn64.size();
+                m_conn64.resize(static_cast<std::size_t>(n));
+                for (std::size_t i = old; i < m_conn64.size(); ++i) m_conn64[i] = static_cast<std::int64_t>(i);
+            }
+            conn.set_external(m_conn64.data(), n);
+        }
+    }
+
+    conduit_node* m_data = nullptr;
+    std::string m_coordset;
+    std::string m_topology;
+    std::vector<std::pair<std::string, unsigned>> m_layout;   // column name, components
+    std::vector<conduit_node*> m_values;                      // one per column component
+    conduit_node* m_connectivity = nullptr;
+    std::vector<std::int32_t> m_conn32;
+    std::vector<std::int64_t> m_conn64;
+};
@@ -0,0 +1,235 @@
+#pragma once
+#include "Vis_forward.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <limits>
+
+#ifdef APL_HAVE_MPI
+#include <mpi.h>
+#endif
+
+// Needs ParticleSoA complete: include via bpl.h.
+
+// Particle reduction for the visualization path: pick at most `budget` particles of a
+// container and publish those instead of all of them.
+// - Stride:     budget particles evenly spread over the index range (i = floor(k n / budget)).
+// - Reservoir:  uniform random subset of exactly `budget` particles (reservoir sampling,
+//               Li's Algorithm L: O(budget (1 + log(n / budget))) random draws).
+// - Importance: weighted sampling without replacement, probability growing with the norm
+//               of an attribute column (e.g. energy, or |velocity| for a vector column):
+//               every particle gets the key log(u_i) / w_i and the budget largest keys win
+//               (Efraimidis-Spirakis). Zero weights are only taken when the budget exceeds
+//               the number of positive weights.
+// The result is a sorted index list (sample_indices) or a compacted copy of all columns
+// (decimate). Results are deterministic for a given seed: the importance keys come from a
+// counter-based hash of (seed, index), so they do not depend on the thread count either.
+// Use a different seed per rank (e.g. seed + rank) to decorrelate the ranks.
+
+enum class SampleMethod { Stride, Reservoir, Importance };
+
+constexpr const char* sample_method_name(SampleMethod m) {
+    switch (m) {
+        case SampleMethod::Stride: return "stride";
+        case SampleMethod::Reservoir: return "reservoir";
+        case SampleMethod::Importance: return "importance";
+    }
+    return "unknown";
+}
+
+struct SampleOptions {
+    SampleMethod method = SampleMethod::Stride;
+    std::size_t budget = 0;         // particles to keep (>= size(): keep all)
+    std::uint64_t seed = 0;
+    std::string weight;             // Importance: attribute column (position scalar type)
+    unsigned nthreads = 0;          // 0: hardware
+};
+
+namespace sample_detail {
+
+// splitmix64 finalizer: independent 64-bit value per (seed, i).
+inline std::uint64_t mix(std::uint64_t seed, std::uint64_t i) noexcept {
+    std::uint64_t z = seed + 0x9e3779b97f4a7c15ull * (i + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Uniform in (0, 1].
+inline double unit(std::uint64_t bits) noexcept {
+    return static_cast<double>((bits >> 11) + 1) * 0x1.0p-53;
+}
+
+// Floor and remainder of a * b / m for a < m, exact without 128-bit products:
+// shift-and-add over the bits of b, keeping the running remainder below m.
+inline std::pair<std::uint64_t, std::uint64_t> mul_div(std::uint64_t a, std::uint64_t b, std::uint64_t m) noexcept {
+    if (b == 0 || a <= std::numeric_limits<std::uint64_t>::max() / b) return {a * b / m, a * b % m};
+    std::uint64_t q = 0, r = 0;
+    for (int bit = 63; bit >= 0; --bit) {
+        q <<= 1;                    // (q, r) doubled: r + r may not fit, so compare against m - r
+        if (r >= m - r) {
+            r -= m - r;
+            ++q;
+        } else {
+            r += r;
+        }
+        if ((b >> bit) & 1u) {      // plus a
+            if (r >= m - a) {
+                r -= m - a;
+                ++q;
+            } else {
+                r += a;
+            }
+        }
+    }
+    return {q, r};
+}
+
+inline std::vector<std::size_t> stride(std::size_t n, std::size_t k) {
+    std::vector<std::size_t> idx(k);
+    for (std::size_t j = 0; j < k; ++j) {
+        idx[j] = j * (n / k) + (j * (n % k)) / k;   // floor(j n / k) without overflowing j n
+    }
+    return idx;
+}
+
+inline std::vector<std::size_t> reservoir(std::size_t n, std::size_t k, std::uint64_t seed) {
+    std::vector<std::size_t> idx(k);
+    for (std::size_t j = 0; j < k; ++j) idx[j] = j;
+    std::mt19937_64 gen(seed);
+    auto u = [&] { return unit(gen()); };
+    double w = std::exp(std::log(u()) / static_cast<double>(k));
+    std::size_t i = k - 1;
+    for (;;) {
+        const double skip = std::floor(std::log(u()) / std::log1p(-w));
+        if (skip >= static_cast<double>(n - 1 - i)) break;
+        i += static_cast<std::size_t>(skip) + 1;
+        idx[gen() % k] = i;
+        w *= std::exp(std::log(u()) / static_cast<double>(k));
+    }
+    std::sort(idx.begin(), idx.end());
+    return idx;
+}
+
+struct Key {
+    double key;
+    std::size_t index;
+    // larger key first, ties by index: a total order, so the pick is deterministic
+    bool operator<(const Key& o) const noexcept { return key > o.key || (key == o.key && index < o.index); }
+};
+
+template <typename Particles>
+std::vector<std::size_t> importance(const Particles& p, std::size_t k, const SampleOptions& o) {
+    using T = typename Particles::value_type;
+    const std::size_t c = p.find(o.weight);
+    if (c == Particles::npos) throw std::invalid_argument("sample: no weight column '" + o.weight + "'");
+    const unsigned comps = p.column(c).components;
+    std::vector<const T*> w(comps);
+    for (unsigned j = 0; j < comps; ++j) w[j] = p.template data<T>(c, j);
+
+    // per chunk: keys, then the chunk's k best; merged and cut again
+    const std::size_t n = p.size();
+    const unsigned nt = apl_thread_count(n, o.nthreads);
+    std::vector<std::vector<Key>> best(nt);
+    parallel_for_chunks(n, nt, [&](std::size_t b, std::size_t e, unsigned t) {
+        std::vector<Key>& keys = best[t];
+        keys.resize(e - b);
+        for (std::size_t i = b; i < e; ++i) {
+            double s = 0.0;
+            for (unsigned j = 0; j < comps; ++j) s += static_cast<double>(w[j][i]) * static_cast<double>(w[j][i]);
+            const double wi = comps == 1 ? std::abs(static_cast<double>(w[0][i])) : std::sqrt(s);
+            const double key = wi > 0.0 ? std::log(unit(mix(o.seed, i))) / wi : -std::numeric_limits<double>::infinity();
+            keys[i - b] = Key{key, i};
+        }
+        if (keys.size() > k) {
+            std::nth_element(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(k), keys.end());
+            keys.resize(k);
+        }
+    });
+    std::vector<Key> all;
+    for (auto& keys : best) all.insert(all.end(), keys.begin(), keys.end());
+    std::nth_element(all.begin(), all.begin() + static_cast<std::ptrdiff_t>(k), all.end());
+    std::vector<std::size_t> idx(k);
+    for (std::size_t j = 0; j < k; ++j) idx[j] = all[j].index;
+    std::sort(idx.begin(), idx.end());
+    return idx;
+}
+
+}  // namespace sample_detail
+
+// Indices (ascending) of the particles to keep.
+template <typename Particles>
+std::vector<std::size_t> sample_indices(const Particles& p, const SampleOptions& o) {
+    const std::size_t n = p.size();
+    const std::size_t k = std::min(o.budget, n);
+    if (k == n) {
+        std::vector<std::size_t> all(n);
+        for (std::size_t i = 0; i < n; ++i) all[i] = i;
+        return all;
+    }
+    if (k == 0) return {};
+    switch (o.method) {
+        case SampleMethod::Stride: return sample_detail::stride(n, k);
+        case SampleMethod::Reservoir: return sample_detail::reservoir(n, k, o.seed);
+        case SampleMethod::Importance: return sample_detail::importance(p, k, o);
+    }
+    return {};
+}
+
+// Compacted copy (all columns) of the particles at `idx` into `out`, which needs the same
+// column layout (e.g. p.empty_like(name)). Reuse `out` across steps: resize() keeps the
+// capacity, so a steady budget allocates nothing.
+template <typename Particles>
+void select_particles(const Particles& p, const std::vector<std::size_t>& idx, Particles& out, unsigned nthreads = 0) {
+    if (!out.same_layout(p)) throw std::invalid_argument("select_particles: output has another column layout");
+    out.resize(idx.size());
+    parallel_for_chunks(idx.size(), apl_thread_count(idx.size(), nthreads), [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t j = b; j < e; ++j) out.copy_particle(p, idx[j], j);
+    });
+    out.touch();
+}
+
+// sample_indices + select_particles.
+template <typename Particles>
+void decimate(const Particles& p, const SampleOptions& o, Particles& out) {
+    select_particles(p, sample_indices(p, o), out, o.nthreads);
+}
+
+// Share of a global budget for `local` particles on this rank: proportional to the local
+// count, remainders assigned by largest fraction (ties: lower rank), so the shares add up
+// to min(global, total particles). Without MPI the share is min(global, local).
+inline std::size_t rank_budget(std::size_t global, std::size_t local) {
+    return std::min(global, local);
+}
+
+#ifdef APL_HAVE_MPI
+inline std::size_t rank_budget(std::size_t global, std::size_t local, MPI_Comm comm) {
+    int rank = 0, size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    const auto mine = static_cast<std::uint64_t>(local);
+    std::vector<std::uint64_t> counts(static_cast<std::size_t>(size));
+    MPI_Allgather(&mine, 1, MPI_UINT64_T, counts.data(), 1, MPI_UINT64_T, comm);
+
+    std::uint64_t total = 0;
+    for (std::uint64_t c : counts) total += c;
+    if (total <= global) return local;
+
+    // floor shares, then one more for the largest remainders
+    std::vector<std::uint64_t> share(counts.size());
+    std::vector<std::pair<std::uint64_t, int>> rem(counts.size());
+    std::uint64_t assigned = 0;
+    for (std::size_t r = 0; r < counts.size(); ++r) {
+        // global < total here; global * counts[r] may exceed 64 bits
+        const auto [q, rest] = sample_detail::mul_div(static_cast<std::uint64_t>(global), counts[r], total);
+        share[r] = q;
+        rem[r] = {rest, static_cast<int>(r)};
+        assigned += share[r];
+    }
+    std::sort(rem.begin(), rem.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    });
+    for (std::uint64_t j = 0; j < global - assigned; ++j) ++share[static_cast<std::size_t>(rem[j].second)];
+    return static_cast<std::size_t>(share[static_cast<std::size_t>(rank)]);
+}
+#endif
@@ -0,0 +1,274 @@
+#pragma once
+#include "Vis_forward.h"
+#include "parallel.h"
+#include "shape.h"
+
+#include <limits>
+
+// Needs GridField and ParticleSoA complete: include via bpl.h.
+
+// Particle-to-grid deposition (density, charge) with NGP / CIC / TSC shapes.
+// Writes into a GridField<T,Dim> (T scalar) from a particle container with size() and
+// pos(a) (ParticleSoA); positions must lie inside the field's owned cells. CIC and TSC
+// reach one cell past them, so the field needs ghost >= 1; the ghost contributions
+// belong to the neighbours and are left for a halo accumulate.
+//
+// No atomics; two ways to keep threads from writing the same cell:
+// - PrivateTiles: every thread deposits its contiguous chunk of particles into a private
+//   tile covering only the cells its chunk touches, then the tiles are summed row by row
+//   (each row written by one thread). With particles sorted by tile (sort_particles) a
+//   chunk is spatially compact and the tiles are small; unsorted, each tile is the whole
+//   grid.
+// - ColoredTiles: needs TileBins. Tiles are split into 2^Dim colors by the parity of their
+//   tile coordinates; tiles of one color are at least one tile apart, so with tile >= 2
+//   their footprints are disjoint and all tiles of a color deposit straight into the field
+//   in parallel. Colors run one after the other.
+//
+// Every particle contributes scale * weight[i] * shape (weight: optional scalar attribute
+// column, e.g. charge, of the position's scalar type); for a density use
+// scale = 1 / map.cell_volume().
+
+enum class DepositMethod { PrivateTiles, ColoredTiles };
+
+constexpr const char* deposit_method_name(DepositMethod m) {
+    return m == DepositMethod::PrivateTiles ? "private" : "colored";
+}
+
+struct DepositOptions {
+    Shape shape = Shape::CIC;
+    DepositMethod method = DepositMethod::PrivateTiles;
+    double scale = 1.0;
+    std::string weight;         // attribute column multiplying each contribution (empty: none)
+    bool accumulate = false;    // add to the field instead of overwriting it (ghosts included)
+    unsigned nthreads = 0;      // 0: hardware
+};
+
+// Per-thread tiles kept between calls (PrivateTiles), so a step allocates nothing.
+template <typename T, unsigned Dim>
+struct DepositWorkspace {
+    struct Tile {
+        std::array<std::ptrdiff_t, Dim> lo{}, hi{};   // allocated-block coordinates, [lo, hi)
+        std::vector<T> values;
+        bool empty = true;
+    };
+    std::vector<Tile> tiles;
+};
+
+namespace deposit_detail {
+
+// Adds v * shape(x) at cells base[sum (i0[a] + shift[a]) * stride[a]].
+template <Shape S, unsigned Dim, typename T, typename P>
+inline void deposit_one(T* base, const std::array<std::size_t, Dim>& stride,
+                        const std::array<std::ptrdiff_t, Dim>& shift, const P* xi, double v) {
+    static_assert(Dim >= 1 && Dim <= 3, "deposit: 1D, 2D or 3D grids");
+    using W = ShapeWeights<S>;
+    constexpr int K = W::support;
+    std::ptrdiff_t i0[Dim];
+    P w[Dim][K];
+    std::size_t c = 0;
+    for (unsigned a = 0; a < Dim; ++a) {
+        W::eval(xi[a], i0[a], w[a]);
+        c += static_cast<std::size_t>(i0[a] + shift[a]) * stride[a];
+    }
+    if constexpr (Dim == 1) {
+        for (int i = 0; i < K; ++i) base[c + i] += static_cast<T>(v * w[0][i]);
+    } else if constexpr (Dim == 2) {
+        for (int j = 0; j < K; ++j) {
+            const double vj = v * w[1][j];
+            T* row = base + c + j * stride[1];
+            for (int i = 0; i < K; ++i) row[i] += static_cast<T>(vj * w[0][i]);
+        }
+    } else {
+        for (int k = 0; k < K; ++k) {
+            for (int j = 0; j < K; ++j) {
+                const double vjk = v * w[2][k] * w[1][j];
+                T* row = base + c + k * stride[2] + j * stride[1];
+                for (int i = 0; i < K; ++i) row[i] += static_cast<T>(vjk * w[0][i]);
+            }
+        }
+    }
+}
+
+// Calls fn(particle index) for positions [b, e) of `order` (or of 0..n-1 without bins).
+template <typename Fn>
+inline void for_range(const std::vector<std::size_t>* order, std::size_t b, std::size_t e, Fn&& fn) {
+    if (order) {
+        for (std::size_t i = b; i < e; ++i) fn((*order)[i]);
+    } else {
+        for (std::size_t i = b; i < e; ++i) fn(i);
+    }
+}
+
+template <Shape S, typename Particles, typename T, unsigned Dim>
+void deposit_private(const Particles& p, GridField<T, Dim>& f, const GridMap<Dim>& map, const DepositOptions& o,
+                     const TileBins<Dim>* bins, DepositWorkspace<T, Dim>& ws) {
+    using P = typename Particles::value_type;
+    const std::size_t n = p.size();
+    const unsigned nt = apl_thread_count(n, o.nthreads);
+    ws.tiles.resize(nt);
+    const std::vector<std::size_t>* order = bins ? &bins->order : nullptr;
+    const P* weight = o.weight.empty() ? nullptr : p.template data<P>(p.find(o.weight));
+    const auto reach = static_cast<std::ptrdiff_t>(shape_reach(S));
+    const auto g = static_cast<std::ptrdiff_t>(f.ghost);
+
+    parallel_for_chunks(n, nt, [&](std::size_t b, std::size_t e, unsigned t) {
+        auto& tile = ws.tiles[t];
+        tile.empty = b == e;
+        if (tile.empty) return;
+        std::array<const P*, Dim> x;
+        for (unsigned a = 0; a < Dim; ++a) x[a] = p.pos(a);
+
+        // footprint of the chunk in allocated-block coordinates
+        std::array<P, Dim> lo, hi;
+        lo.fill(std::numeric_limits<P>::max());
+        hi.fill(std::numeric_limits<P>::lowest());
+        for_range(order, b, e, [&](std::size_t i) {
+            for (unsigned a = 0; a < Dim; ++a) {
+                lo[a] = std::min(lo[a], x[a][i]);
+                hi[a] = std::max(hi[a], x[a][i]);
+            }
+        });
+        std::size_t count = 1;
+        std::array<std::size_t, Dim> stride;
+        std::array<std::ptrdiff_t, Dim> shift;
+        for (unsigned a = 0; a < Dim; ++a) {
+            const auto cl = static_cast<std::ptrdiff_t>(std::floor(map.cell_coord(a, lo[a]) + 0.5));
+            const auto ch = static_cast<std::ptrdiff_t>(std::floor(map.cell_coord(a, hi[a]) + 0.5));
+            tile.lo[a] = std::max<std::ptrdiff_t>(0, cl - reach + g);
+            tile.hi[a] = std::min<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(f.allocated(a)), ch + reach + g + 1);
+            stride[a] = count;
+            shift[a] = g - tile.lo[a];
+            count *= static_cast<std::size_t>(tile.hi[a] - tile.lo[a]);
+        }
+        tile.values.assign(count, T{});
+
+        T* base = tile.values.data();
+        for_range(order, b, e, [&](std::size_t i) {
+            P xi[Dim];
+            for (unsigned a = 0; a < Dim; ++a) xi[a] = static_cast<P>(map.cell_coord(a, x[a][i]));
+            deposit_one<S, Dim>(base, stride, shift, xi, weight ? o.scale * weight[i] : o.scale);
+        });
+    });
+
+    // sum the tiles row by row (rows along axis 0 of the allocated block)
+    std::size_t rows = 1;
+    for (unsigned a = 1; a < Dim; ++a) rows *= f.allocated(a);
+    const std::size_t nx = f.allocated(0);
+    const unsigned nr = std::min<unsigned>(apl_thread_count(rows * nx, o.nthreads), static_cast<unsigned>(rows));
+    parallel_for_chunks(rows, nr, [&](std::size_t rb, std::size_t re, unsigned) {
+        for (std::size_t r = rb; r < re; ++r) {
+            T* out = f.data() + r * nx;
+            if (!o.accumulate) std::fill(out, out + nx, T{});
+            std::array<std::ptrdiff_t, Dim> rc{};
+            for (std::size_t a = 1, q = r; a < Dim; ++a) {
+                rc[a] = static_cast<std::ptrdiff_t>(q % f.allocated(a));
+                q /= f.allocated(a);
+            }
+            for (const auto& tile : ws.tiles) {
+                if (tile.empty) continue;
+                bool inside = true;
+                std::size_t off = 0, s = static_cast<std::size_t>(tile.hi[0] - tile.lo[0]);
+                for (unsigned a = 1; a < Dim && inside; ++a) {
+                    inside = rc[a] >= tile.lo[a] && rc[a] < tile.hi[a];
+                    off += static_cast<std::size_t>(rc[a] - tile.lo[a]) * s;
+                    s *= static_cast<std::size_t>(tile.hi[a] - tile.lo[a]);
+                }
+                if (!inside) continue;
+                const T* in = tile.values.data() + off;
+                T* o0 = out + tile.lo[0];
+                const std::size_t len = static_cast<std::size_t>(tile.hi[0] - tile.lo[0]);
+                for (std::size_t i = 0; i < len; ++i) o0[i] += in[i];
+            }
+        }
+    });
+}
+
+template <Shape S, typename Particles, typename T, unsigned Dim>
+void deposit_colored(const Particles& p, GridField<T, Dim>& f, const GridMap<Dim>& map, const DepositOptions& o,
+                     const TileBins<Dim>& bins) {
+    using P = typename Particles::value_type;
+    if (shape_reach(S) > 0 && bins.tile < 2) {
+        throw std::invalid_argument("deposit: colored tiles need tile >= 2 for " + std::string(shape_name(S)));
+    }
+    if (!o.accumulate) {
+        parallel_for_chunks(f.size(), apl_thread_count(f.size(), o.nthreads), [&](std::size_t b, std::size_t e, unsigned) {
+            std::fill(f.data() + b, f.data() + e, T{});
+        });
+    }
+    const P* weight = o.weight.empty() ? nullptr : p.template data<P>(p.find(o.weight));
+    std::array<const P*, Dim> x;
+    std::array<std::size_t, Dim> stride;
+    std::array<std::ptrdiff_t, Dim> shift;
+    for (unsigned a = 0; a < Dim; ++a) {
+        x[a] = p.pos(a);
+        stride[a] = f.stride(a);
+        shift[a] = static_cast<std::ptrdiff_t>(f.ghost);
+    }
+
+    std::vector<std::size_t> same_color;
+    for (unsigned color = 0; color < (1u << Dim); ++color) {
+        same_color.clear();
+        for (std::size_t t = 0; t < bins.num_tiles(); ++t) {
+            if (bins.begin[t] == bins.begin[t + 1]) continue;
+            const auto tc = bins.tile_coords(t);
+            unsigned c = 0;
+            for (unsigned a = 0; a < Dim; ++a) c |= static_cast<unsigned>(tc[a] & 1u) << a;
+            if (c == color) same_color.push_back(t);
+        }
+        if (same_color.empty()) continue;
+        std::size_t work = 0;
+        for (std::size_t t : same_color) work += bins.begin[t + 1] - bins.begin[t];
+        const unsigned nt = std::min<unsigned>(apl_thread_count(work, o.nthreads),
+                                               static_cast<unsigned>(same_color.size()));
+        parallel_for_chunks(same_color.size(), nt, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t j = b; j < e; ++j) {
+                const std::size_t t = same_color[j];
+                for_range(&bins.order, bins.begin[t], bins.begin[t + 1], [&](std::size_t i) {
+                    P xi[Dim];
+                    for (unsigned a = 0; a < Dim; ++a) xi[a] = static_cast<P>(map.cell_coord(a, x[a][i]));
+                    deposit_one<S, Dim>(f.data(), stride, shift, xi, weight ? o.scale * weight[i] : o.scale);
+                });
+            }
+        });
+    }
+}
+
+template <Shape S, typename Particles, typename T, unsigned Dim>
+void deposit_shape(const Particles& p, GridField<T, Dim>& f, const GridMap<Dim>& map, const DepositOptions& o,
+                   const TileBins<Dim>* bins, DepositWorkspace<T, Dim>& ws) {
+    if (o.method == DepositMethod::ColoredTiles) {
+        if (!bins) throw std::invalid_argument("deposit: colored tiles need TileBins (bin_particles)");
+        deposit_colored<S>(p, f, map, o, *bins);
+    } else {
+        deposit_private<S>(p, f, map, o, bins, ws);
+    }
+}
+
+}  // namespace deposit_detail
+
+// Deposit the particles of `p` onto `f`. `bins` (from bin_particles on the current
+// positions) is required for ColoredTiles and orders the chunks for PrivateTiles; `ws`
+// keeps the private tiles between calls.
+template <typename Particles, typename T, unsigned Dim>
+void deposit(const Particles& p, GridField<T, Dim>& f, const GridMap<Dim>& map, const DepositOptions& o = {},
+             const std::type_identity_t<TileBins<Dim>>* bins = nullptr,
+             std::type_identity_t<DepositWorkspace<T, Dim>>* ws = nullptr) {
+    static_assert(std::is_arithmetic_v<T>, "deposit: scalar grid fields only");
+    static_assert(Particles::dim == Dim, "deposit: particle and grid dimensions differ");
+    if (f.ghost < shape_reach(o.shape)) {
+        throw std::invalid_argument("deposit: " + std::string(shape_name(o.shape)) + " needs ghost >= " +
+                                    std::to_string(shape_reach(o.shape)) + " on '" + f.field_ID + "'");
+    }
+    if (bins && bins->order.size() != p.size()) throw std::invalid_argument("deposit: bins are for another particle count");
+    if (!o.weight.empty() && p.find(o.weight) == Particles::npos) {
+        throw std::invalid_argument("deposit: no weight column '" + o.weight + "'");
+    }
+    DepositWorkspace<T, Dim> local;
+    DepositWorkspace<T, Dim>& w = ws ? *ws : local;
+    switch (o.shape) {
+        case Shape::NGP: deposit_detail::deposit_shape<Shape::NGP>(p, f, map, o, bins, w); break;
+        case Shape::CIC: deposit_detail::deposit_shape<Shape::CIC>(p, f, map, o, bins, w); break;
+        case Shape::TSC: deposit_detail::deposit_shape<Shape::TSC>(p, f, map, o, bins, w); break;
+    }
+    f.touch();
+}
@@ -0,0 +1,115 @@
+// Throughput of particle-to-grid deposition (deposit.h) against the thread count.
+//
+// Uniformly random particles in a cubic grid (one ghost layer). For every shape:
+// - private/unsorted: PrivateTiles on the particles in generation order (each thread's
+//   tile is the whole grid)
+// - private/sorted:   PrivateTiles after sort_particles (small tiles)
+// - colored/sorted:   ColoredTiles on the same sorted particles
+// Rates are particles per second of one deposit() call (best of `reps`), including the
+// thread spawn and the tile reduction. "err" is the largest difference to the serial
+// result relative to its largest value; "sum-n" checks that every particle deposited
+// weight 1. Binning + sorting is timed once and reported separately.
+//
+// Usage: ./bild/deposit_bench [particles=4194304] [cells=64] [reps=5]
+
+constexpr unsigned Dim = 3;
+using T = double;
+#include "bpl.h"
+
+#include <chrono>
+#include <iomanip>
+
+using clk = std::chrono::steady_clock;
+using Grid = GridField<double, 3>;
+using Particles = ParticleSoA<double, 3>;
+
+static double seconds_since(clk::time_point t0) {
+    return std::chrono::duration<double>(clk::now() - t0).count();
+}
+
+static double max_diff(const Grid& a, const Grid& b) {
+    double d = 0.0, m = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        d = std::max(d, std::abs(a.values[i] - b.values[i]));
+        m = std::max(m, std::abs(b.values[i]));
+    }
+    return m > 0.0 ? d / m : d;
+}
+
+static double sum(const Grid& g) {
+    double s = 0.0;
+    for (double v : g.values) s += v;
+    return s;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoull(argv[1]) : (std::size_t{1} << 22);
+    const std::size_t cells = argc > 2 ? std::stoull(argv[2]) : 64;
+    const int reps = argc > 3 ? std::stoi(argv[3]) : 5;
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+
+    Particles unsorted("bench", n);
+    std::mt19937_64 gen(1);
+    std::uniform_real_distribution<double> u(0.0, static_cast<double>(cells));
+    for (unsigned a = 0; a < 3; ++a) {
+        double* x = unsorted.pos(a);
+        for (std::size_t i = 0; i < n; ++i) x[i] = u(gen);
+    }
+
+    Grid grid("rho", {cells, cells, cells}, 1), reference("reference", {cells, cells, cells}, 1);
+    const GridMap<3> map;
+
+    auto t0 = clk::now();
+    TileBins<3> bins = bin_particles(unsorted, grid, map, 8);
+    const double t_bin = seconds_since(t0);
+    Particles sorted = unsorted;
+    t0 = clk::now();
+    sort_particles(sorted, bins);
+    const double t_sort = seconds_since(t0);
+
+    std::cout << "particles: " << n << ", grid: " << cells << "^3 (+1 ghost), " << hw << " hardware threads\n"
+              << "bin (tile 8): " << std::fixed << std::setprecision(1) << 1e3 * t_bin << " ms, sort: "
+              << 1e3 * t_sort << " ms\n";
+    std::cout << std::left << std::setw(7) << "shape" << std::setw(18) << "method" << std::right << std::setw(8)
+              << "threads" << std::setw(14) << "Mparticles/s" << std::setw(10) << "speedup" << std::setw(11) << "err"
+              << std::setw(14) << "sum-n" << "\n";
+
+    std::vector<unsigned> threads;
+    for (unsigned t = 1; t < hw; t *= 2) threads.push_back(t);
+    threads.push_back(hw);
+
+    for (Shape shape : {Shape::NGP, Shape::CIC, Shape::TSC}) {
+        DepositOptions ref;
+        ref.shape = shape;
+        ref.nthreads = 1;
+        deposit(unsorted, reference, map, ref);
+
+        for (int variant = 0; variant < 3; ++variant) {
+            const bool use_sorted = variant > 0;
+            const Particles& p = use_sorted ? sorted : unsorted;
+            DepositOptions o;
+            o.shape = shape;
+            o.method = variant == 2 ? DepositMethod::ColoredTiles : DepositMethod::PrivateTiles;
+            const std::string label = std::string(deposit_method_name(o.method)) + (use_sorted ? "/sorted" : "/unsorted");
+            DepositWorkspace<double, 3> ws;
+            double rate1 = 0.0;
+            for (unsigned t : threads) {
+                o.nthreads = t;
+                double best = 1e30;
+                for (int r = 0; r < reps; ++r) {
+                    t0 = clk::now();
+                    deposit(p, grid, map, o, use_sorted ? &bins : nullptr, &ws);
+                    best = std::min(best, seconds_since(t0));
+                }
+                const double rate = static_cast<double>(n) / best;
+                if (t == 1) rate1 = rate;
+                std::cout << std::left << std::setw(7) << shape_name(shape) << std::setw(18) << label << std::right
+                          << std::setw(8) << t << std::setw(14) << std::setprecision(1) << rate * 1e-6
+                          << std::setw(10) << std::setprecision(2) << rate / rate1 << std::setw(11)
+                          << std::scientific << std::setprecision(1) << max_diff(grid, reference) << std::setw(14)
+                          << sum(grid) - static_cast<double>(n) << std::fixed << "\n";
+            }
+        }
+    }
+    return 0;
+}
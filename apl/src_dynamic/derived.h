@@ -0,0 +1,200 @@
+#pragma once
+#include "Vis_forward.h"
+#include "parallel.h"
+
+#include <exception>
+#include <thread>
+
+// Needs RegistryDynamic, Field_b and ParticleBase_b complete: include via bpl.h.
+
+// Derived-field engine on top of RegistryDynamic.
+// - A derived field is a node: a name, the names of its inputs, a compute function and
+//   an owned output object. The output is bound into the registry under the node name
+//   (runtime string API), so consumers find it like any other entry.
+// - Inputs are bound Fields / particle containers (tracked through their `version`,
+//   bumped by touch()) or other derived nodes.
+// - Nothing runs at registration or per step: evaluate()/get() computes only the
+//   requested nodes and their dependencies, and only those whose input versions changed
+//   since their last evaluation.
+// - The requested sub-graph is split into dependency levels; stale nodes of one level are
+//   independent and run on separate threads.
+
+class DerivedFieldGraph {
+    struct Node {
+        std::vector<std::string> inputs;
+        std::vector<std::uint64_t> seen;  // input versions at the last evaluation
+        std::uint64_t version = 0;        // output version, bumped on every evaluation
+        bool computed = false;
+        std::size_t evaluations = 0;
+        std::shared_ptr<void> output;     // owned result object
+        const std::type_info* output_type = nullptr;
+        std::function<void()> run;        // compute(output)
+    };
+
+    RegistryDynamic& m_reg;
+    unsigned m_nthreads;
+    std::unordered_map<std::string, Node> m_nodes;
+
+public:
+    // nthreads == 0: use the hardware concurrency.
+    explicit DerivedFieldGraph(RegistryDynamic& reg, unsigned nthreads = 0)
+        : m_reg(reg), m_nthreads(nthreads ? nthreads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    ~DerivedFieldGraph() {
+        for (const auto& kv : m_nodes) m_reg.unset_named(kv.first);
+    }
+
+    DerivedFieldGraph(const DerivedFieldGraph&) = delete;
+    DerivedFieldGraph& operator=(const DerivedFieldGraph&) = delete;
+
+    // Register a derived field `name` computed by compute(Out&) from `inputs`.
+    // The compute function captures its inputs itself; `inputs` declares the dependencies.
+    // Returns the output object (also bound in the registry as `name`).
+    template<typename Out, typename Fn>
+    Out& add(const std::string& name, std::vector<std::string> inputs, Fn&& compute, Out initial = Out{}) {
+        if (m_nodes.count(name)) {
+            throw std::invalid_argument("DerivedFieldGraph: node '" + name + "' already exists");
+        }
+        if (m_reg.contains_named(name)) {
+            throw std::invalid_argument("DerivedFieldGraph: name '" + name + "' is already bound in the registry");
+        }
+        auto out = std::make_shared<Out>(std::move(initial));
+        Out* raw = out.get();
+
+        Node node;
+        node.inputs = std::move(inputs);
+        node.output = out;
+        node.output_type = &typeid(Out);
+        node.run = [raw, fn = std::forward<Fn>(compute)]() mutable {
+            fn(*raw);
+            if constexpr (std::is_base_of_v<Field_b, Out> || std::is_base_of_v<ParticleBase_b, Out>) {
+                raw->touch();  // downstream consumers of the bound object see the new version
+            }
+        };
+        m_nodes.emplace(name, std::move(node));
+        m_reg.set_named(name, *raw);
+        return *raw;
+    }
+
+    bool remove(const std::string& name) {
+        if (!m_nodes.erase(name)) return false;
+        m_reg.unset_named(name);
+        return true;
+    }
+
+    bool contains(const std::string& name) const { return m_nodes.count(name) > 0; }
+
+    // Version of any input (derived node, bound Field, bound particle container).
+    std::uint64_t version_of(const std::string& name) const {
+        if (auto it = m_nodes.find(name); it != m_nodes.end()) return it->second.version;
+        if (const Field_b* f = m_reg.find_field(name)) return f->version;
+        if (const ParticleBase_b* p = m_reg.find_particles(name)) return p->version;
+        throw std::runtime_error("DerivedFieldGraph: unknown input '" + name +
+                                 "' (not a derived node, Field or particle container in the registry)");
+    }
+
+    // True if evaluating `name` would recompute it (or one of its derived inputs).
+    bool is_stale(const std::string& name) const {
+        const Node& n = node(name);
+        if (!n.computed) return true;
+        for (std::size_t i = 0; i < n.inputs.size(); ++i) {
+            if (m_nodes.count(n.inputs[i]) && is_stale(n.inputs[i])) return true;
+            if (version_of(n.inputs[i]) != n.seen[i]) return true;
+        }
+        return false;
+    }
+
+    std::size_t evaluations(const std::string& name) const { return node(name).evaluations; }
+
+    // Bring the requested nodes up to date (dependencies first, independent nodes in parallel).
+    void evaluate(const std::vector<std::string>& names) {
+        std::unordered_map<std::string, int> level;  // node -> dependency level
+        for (const auto& n : names) collect(n, level);
+
+        int max_level = -1;
+        for (const auto& kv : level) max_level = std::max(max_level, kv.second);
+        std::vector<std::vector<Node*>> levels(static_cast<std::size_t>(max_level + 1));
+        for (const auto& kv : level) levels[static_cast<std::size_t>(kv.second)].push_back(&m_nodes.at(kv.first));
+
+        for (auto& lvl : levels) {
+            // Decide staleness once the previous level is final.
+            std::vector<std::pair<Node*, std::vector<std::uint64_t>>> todo;
+            for (Node* n : lvl) {
+                std::vector<std::uint64_t> now(n->inputs.size());
+                for (std::size_t i = 0; i < n->inputs.size(); ++i) now[i] = version_of(n->inputs[i]);
+                if (!n->computed || now != n->seen) todo.emplace_back(n, std::move(now));
+            }
+            run_level(todo);
+        }
+    }
+
+    void evaluate(const std::string& name) { evaluate(std::vector<std::string>{name}); }
+
+    // Evaluate on demand and return the typed output.
+    template<typename Out>
+    Out& get(const std::string& name) {
+        const Node& n = node(name);
+        if (*n.output_type != typeid(Out)) {
+            throw std::invalid_argument("DerivedFieldGraph: wrong output type requested for '" + name + "'");
+        }
+        evaluate(name);
+        return *static_cast<Out*>(n.output.get());
+    }
+
+private:
+    const Node& node(const std::string& name) const {
+        auto it = m_nodes.find(name);
+        if (it == m_nodes.end()) throw std::runtime_error("DerivedFieldGraph: unknown node '" + name + "'");
+        return it->second;
+    }
+
+    // DFS over derived inputs; level = 1 + max level of derived inputs. -1 marks "in progress".
+    int collect(const std::string& name, std::unordered_map<std::string, int>& level) {
+        if (auto it = level.find(name); it != level.end()) {
+            if (it->second < 0) throw std::runtime_error("DerivedFieldGraph: dependency cycle through '" + name + "'");
+            return it->second;
+        }
+        const Node& n = node(name);
+        level[name] = -1;
+        int lv = 0;
+        for (const auto& in : n.inputs) {
+            if (m_nodes.count(in)) {
+                lv = std::max(lv, collect(in, level) + 1);
+            } else {
+                (void)version_of(in);  // validates that the source exists
+            }
+        }
+        level[name] = lv;
+        return lv;
+    }
+
+    void run_level(std::vector<std::pair<Node*, std::vector<std::uint64_t>>>& todo) {
+        if (todo.empty()) return;
+        std::vector<std::exception_ptr> errors(todo.size());
+        auto run_one = [&](std::size_t i) {
+            try {
+                todo[i].first->run();
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        };
+
+        const std::size_t nt = std::min<std::size_t>(m_nthreads, todo.size());
+        if (nt <= 1) {
+            for (std::size_t i = 0; i < todo.size(); ++i) run_one(i);
+        } else {
+            parallel_for_chunks(todo.size(), static_cast<unsigned>(nt), [&](std::size_t b, std::size_t e, unsigned) {
+                for (std::size_t i = b; i < e; ++i) run_one(i);
+            });
+        }
+
+        for (std::size_t i = 0; i < todo.size(); ++i) {
+            if (errors[i]) std::rethrow_exception(errors[i]);
+            Node* n = todo[i].first;
+            n->seen = std::move(todo[i].second);
+            n->computed = true;
+            ++n->version;
+            ++n->evaluations;
+        }
+    }
+};
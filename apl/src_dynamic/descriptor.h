@@ -0,0 +1,163 @@
+#pragma once
+#include "Vis_forward.h"
+
+// Type-erased, zero-copy description of field / particle storage (DLPack-like).
+// A DataDescriptor tells a consumer (Conduit, writers, Python) everything needed to wrap
+// the memory without copying it: raw pointer, scalar dtype, number of components per
+// element, extents and byte strides, plus a lifetime guard.
+//
+// Conventions
+// - Axis 0 is the fastest varying one (i, j, k order as in Conduit/VTK).
+// - Strides are in bytes. For AoS vec<S,N> elements the element stride is sizeof(vec<S,N>)
+//   and consecutive components are `component_stride` bytes apart.
+// - component(c) returns a strided scalar view of component c (no copy).
+
+inline constexpr unsigned apl_max_ndim = 4;
+
+enum class DType : std::uint8_t {
+    Int8, Int16, Int32, Int64,
+    UInt8, UInt16, UInt32, UInt64,
+    Float32, Float64
+};
+
+template <typename S>
+constexpr DType dtype_of() {
+    static_assert(std::is_arithmetic_v<S>, "dtype_of: only arithmetic scalar types have a DType");
+    if constexpr (std::is_floating_point_v<S>) {
+        static_assert(sizeof(S) == 4 || sizeof(S) == 8, "dtype_of: unsupported floating-point width");
+        return sizeof(S) == 4 ? DType::Float32 : DType::Float64;
+    } else if constexpr (std::is_signed_v<S>) {
+        return sizeof(S) == 1 ? DType::Int8 : sizeof(S) == 2 ? DType::Int16
+             : sizeof(S) == 4 ? DType::Int32 : DType::Int64;
+    } else {
+        return sizeof(S) == 1 ? DType::UInt8 : sizeof(S) == 2 ? DType::UInt16
+             : sizeof(S) == 4 ? DType::UInt32 : DType::UInt64;
+    }
+}
+
+constexpr std::size_t dtype_size(DType t) {
+    switch (t) {
+        case DType::Int8: case DType::UInt8: return 1;
+        case DType::Int16: case DType::UInt16: return 2;
+        case DType::Int32: case DType::UInt32: case DType::Float32: return 4;
+        case DType::Int64: case DType::UInt64: case DType::Float64: return 8;
+    }
+    return 0;
+}
+
+constexpr const char* dtype_name(DType t) {
+    switch (t) {
+        case DType::Int8: return "int8";
+        case DType::Int16: return "int16";
+        case DType::Int32: return "int32";
+        case DType::Int64: return "int64";
+        case DType::UInt8: return "uint8";
+        case DType::UInt16: return "uint16";
+        case DType::UInt32: return "uint32";
+        case DType::UInt64: return "uint64";
+        case DType::Float32: return "float32";
+        case DType::Float64: return "float64";
+    }
+    return "unknown";
+}
+
+struct DataDescriptor {
+    void* data = nullptr;                      // first component of the first element
+    DType dtype = DType::Float64;              // scalar type of one component
+    unsigned components = 1;                   // N for vec<S,N>, 1 for scalars
+    unsigned ndim = 0;                         // number of used extents
+    std::array<std::int64_t, apl_max_ndim> extents{};  // elements per axis (axis 0 fastest)
+    std::array<std::int64_t, apl_max_ndim> strides{};  // bytes between neighbours along each axis
+    std::int64_t component_stride = 0;        // bytes between consecutive components
+
+    // Lifetime guard:
+    // - keepalive: shared ownership of the storage when the producer can hand it out
+    //   (null when the memory is owned by a user object).
+    // - owner: expires when the owning field / container is destroyed.
+    std::shared_ptr<const void> keepalive;
+    std::weak_ptr<const void> owner;
+
+    bool valid() const noexcept { return data != nullptr && (keepalive || !owner.expired()); }
+
+    std::int64_t num_elements() const noexcept {
+        std::int64_t n = ndim ? 1 : 0;
+        for (unsigned a = 0; a < ndim; ++a) n *= extents[a];
+        return n;
+    }
+
+    std::int64_t num_values() const noexcept { return num_elements() * components; }
+
+    std::size_t element_bytes() const noexcept { return dtype_size(dtype) * components; }
+
+    // Densely packed elements (components may still be interleaved AoS).
+    bool contiguous() const noexcept {
+        std::int64_t expect = static_cast<std::int64_t>(element_bytes());
+        for (unsigned a = 0; a < ndim; ++a) {
+            if (strides[a] != expect) return false;
+            expect *= extents[a];
+        }
+        return components == 1 || component_stride == static_cast<std::int64_t>(dtype_size(dtype));
+    }
+
+    // Strided scalar view of one component.
+    DataDescriptor component(unsigned c) const {
+        if (c >= components) {
+            throw std::out_of_range("DataDescriptor::component: " + std::to_string(c) +
+                                    " >= " + std::to_string(components));
+        }
+        DataDescriptor d = *this;
+        d.data = static_cast<char*>(data) + static_cast<std::int64_t>(c) * component_stride;
+        d.components = 1;
+        d.component_stride = 0;
+        return d;
+    }
+
+    // Typed access with a dtype check.
+    template <typename S>
+    S* as() const {
+        if (dtype_of<S>() != dtype) {
+            throw std::invalid_argument(std::string("DataDescriptor: requested ") + dtype_name(dtype_of<S>()) +
+                                        " but storage is " + dtype_name(dtype));
+        }
+        return static_cast<S*>(data);
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const DataDescriptor& d) {
+    os << "{" << dtype_name(d.dtype) << " x" << d.components << ", extents=[";
+    for (unsigned a = 0; a < d.ndim; ++a) os << d.extents[a] << (a + 1 < d.ndim ? "," : "");
+    os << "], strides=[";
+    for (unsigned a = 0; a < d.ndim; ++a) os << d.strides[a] << (a + 1 < d.ndim ? "," : "");
+    os << "], cstride=" << d.component_stride << (d.valid() ? "" : ", expired") << "}";
+    return os;
+}
+
+// Describe `count` contiguous elements of type T (scalar or vec<S,N>) as a 1D array.
+template <typename T>
+DataDescriptor describe_contiguous(const T* ptr, std::int64_t count) {
+    using S = scalar_type_t<T>;
+    constexpr unsigned N = vector_dimension_v<T>;
+    static_assert(sizeof(T) == sizeof(S) * N, "describe_contiguous: element type is not densely packed");
+    DataDescriptor d;
+    d.data = const_cast<T*>(ptr);
+    d.dtype = dtype_of<S>();
+    d.components = N;
+    d.ndim = 1;
+    d.extents[0] = count;
+    d.strides[0] = static_cast<std::int64_t>(sizeof(T));
+    d.component_stride = static_cast<std::int64_t>(sizeof(S));
+    return d;
+}
+
+// Per-object liveness token for DataDescriptor::owner. Copies get their own token,
+// so a descriptor never outlives the object it was taken from unnoticed.
+class LifetimeToken {
+    std::shared_ptr<const void> m_token = std::make_shared<char>(0);
+
+public:
+    LifetimeToken() = default;
+    LifetimeToken(const LifetimeToken&) : LifetimeToken() {}
+    LifetimeToken& operator=(const LifetimeToken&) { return *this; }
+
+    std::weak_ptr<const void> weak() const noexcept { return m_token; }
+};
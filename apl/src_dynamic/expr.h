@@ -0,0 +1,291 @@
+#pragma once
+#include "Vis_forward.h"
+#include "parallel.h"
+
+#include <cmath>
+
+// Lazy expression templates for derived fields.
+// Writing `mag(E)`, `dot(E, B)` or `rho * phi` on Fields builds an expression tree
+// (no temporaries, no work). The tree is evaluated element by element in one fused
+// loop when somebody asks for it:
+//   - evaluate_into(expr, out_ptr)   straight into an export/staging buffer
+//   - assign(field, expr)            into an existing Field
+//   - LazyField<T>                   type-erased handle that can be registered and
+//                                    evaluated later by the visualization side
+// Field operands are captured by pointer, so a stored expression always reads the
+// current field values at evaluation time.
+
+
+
+// === vec arithmetic (element level) ===
+
+template <typename T, unsigned N>
+vec<T, N> operator+(const vec<T, N>& a, const vec<T, N>& b) {
+    vec<T, N> r;
+    for (unsigned i = 0; i < N; ++i) r[i] = a[i] + b[i];
+    return r;
+}
+
+template <typename T, unsigned N>
+vec<T, N> operator-(const vec<T, N>& a, const vec<T, N>& b) {
+    vec<T, N> r;
+    for (unsigned i = 0; i < N; ++i) r[i] = a[i] - b[i];
+    return r;
+}
+
+template <typename T, unsigned N>
+vec<T, N> operator-(const vec<T, N>& a) {
+    vec<T, N> r;
+    for (unsigned i = 0; i < N; ++i) r[i] = -a[i];
+    return r;
+}
+
+template <typename T, unsigned N, typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>>
+vec<T, N> operator*(const vec<T, N>& a, S s) {
+    vec<T, N> r;
+    for (unsigned i = 0; i < N; ++i) r[i] = a[i] * s;
+    return r;
+}
+
+template <typename T, unsigned N, typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>>
+vec<T, N> operator*(S s, const vec<T, N>& a) { return a * s; }
+
+template <typename T, unsigned N, typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>>
+vec<T, N> operator/(const vec<T, N>& a, S s) {
+    vec<T, N> r;
+    for (unsigned i = 0; i < N; ++i) r[i] = a[i] / s;
+    return r;
+}
+
+template <typename T, unsigned N>
+T dot(const vec<T, N>& a, const vec<T, N>& b) {
+    T r{};
+    for (unsigned i = 0; i < N; ++i) r += a[i] * b[i];
+    return r;
+}
+
+template <typename T>
+vec<T, 3> cross(const vec<T, 3>& a, const vec<T, 3>& b) {
+    return vec<T, 3>{{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]}};
+}
+
+template <typename T, unsigned N>
+auto mag(const vec<T, N>& a) { return std::sqrt(dot(a, a)); }
+
+// Scalars: |x| so mag() is defined for every element type.
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+auto mag(T x) { return std::abs(x); }
+
+
+
+// === Expression nodes ===
+
+// CRTP base; only used to recognise expression types.
+template <typename E>
+struct FieldExpr {
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+template <typename X>
+constexpr bool is_field_expr_v = std::is_base_of_v<FieldExpr<X>, X>;
+
+template <typename X>
+struct is_field : std::false_type {};
+
+template <typename T, unsigned Dim>
+struct is_field<Field<T, Dim>> : std::true_type {};
+
+template <typename X>
+constexpr bool is_field_v = is_field<X>::value;
+
+// Something that may appear as an operand of a field expression.
+template <typename X>
+concept field_operand = is_field_v<std::remove_cvref_t<X>> || is_field_expr_v<std::remove_cvref_t<X>>;
+
+// Leaf: contiguous storage (no ownership).
+template <typename T>
+struct FieldTerm : FieldExpr<FieldTerm<T>> {
+    using value_type = T;
+    const T* ptr;
+    std::size_t n;
+    FieldTerm(const T* p, std::size_t count) : ptr(p), n(count) {}
+    std::size_t size() const noexcept { return n; }
+    const T& operator[](std::size_t i) const noexcept { return ptr[i]; }
+};
+
+// Leaf: a broadcast constant; size() == npos marks "matches anything".
+template <typename T>
+struct ScalarTerm : FieldExpr<ScalarTerm<T>> {
+    using value_type = T;
+    T v;
+    explicit ScalarTerm(T value) : v(value) {}
+    std::size_t size() const noexcept { return static_cast<std::size_t>(-1); }
+    T operator[](std::size_t) const noexcept { return v; }
+};
+
+template <typename Op, typename A>
+struct UnaryExpr : FieldExpr<UnaryExpr<Op, A>> {
+    using value_type = std::remove_cvref_t<decltype(Op{}(std::declval<typename A::value_type>()))>;
+    A a;
+    explicit UnaryExpr(A arg) : a(std::move(arg)) {}
+    std::size_t size() const noexcept { return a.size(); }
+    value_type operator[](std::size_t i) const { return Op{}(a[i]); }
+};
+
+template <typename Op, typename L, typename R>
+struct BinaryExpr : FieldExpr<BinaryExpr<Op, L, R>> {
+    using value_type = std::remove_cvref_t<decltype(Op{}(std::declval<typename L::value_type>(),
+                                                         std::declval<typename R::value_type>()))>;
+    L l;
+    R r;
+    BinaryExpr(L lhs, R rhs) : l(std::move(lhs)), r(std::move(rhs)) {
+        constexpr auto any = static_cast<std::size_t>(-1);
+        if (l.size() != any && r.size() != any && l.size() != r.size()) {
+            throw std::invalid_argument("Field expression: operand sizes differ (" +
+                                        std::to_string(l.size()) + " vs " + std::to_string(r.size()) + ")");
+        }
+    }
+    std::size_t size() const noexcept { return l.size() != static_cast<std::size_t>(-1) ? l.size() : r.size(); }
+    value_type operator[](std::size_t i) const { return Op{}(l[i], r[i]); }
+};
+
+// Turn any operand into an expression node.
+template <typename T, unsigned Dim>
+FieldTerm<T> as_expr(const Field<T, Dim>& f) { return FieldTerm<T>(f.data.data(), f.data.size()); }
+
+template <typename E, typename = std::enable_if_t<is_field_expr_v<E>>>
+const E& as_expr(const E& e) { return e; }
+
+template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>>
+ScalarTerm<S> as_expr(S s) { return ScalarTerm<S>(s); }
+
+template <typename X>
+using expr_t = std::remove_cvref_t<decltype(as_expr(std::declval<const X&>()))>;
+
+
+
+// === Element operations ===
+
+struct ExprAdd   { template <typename A, typename B> auto operator()(const A& a, const B& b) const { return a + b; } };
+struct ExprSub   { template <typename A, typename B> auto operator()(const A& a, const B& b) const { return a - b; } };
+struct ExprMul   { template <typename A, typename B> auto operator()(const A& a, const B& b) const { return a * b; } };
+struct ExprDiv   { template <typename A, typename B> auto operator()(const A& a, const B& b) const { return a / b; } };
+struct ExprDot   { template <typename A, typename B> auto operator()(const A& a, const B& b) const { return dot(a, b); } };
+struct ExprCross { template <typename A, typename B> auto operator()(const A& a, const B& b) const { return cross(a, b); } };
+struct ExprNeg   { template <typename A> auto operator()(const A& a) const { return -a; } };
+struct ExprMag   { template <typename A> auto operator()(const A& a) const { return mag(a); } };
+
+
+
+// === Builders (operators on Fields / expressions, scalars broadcast) ===
+
+template <typename Op, typename L, typename R>
+auto make_binary(const L& l, const R& r) {
+    return BinaryExpr<Op, expr_t<L>, expr_t<R>>(as_expr(l), as_expr(r));
+}
+
+// Binary operators need at least one field operand; the other may be a scalar.
+template <typename L, typename R>
+concept field_binary_operands =
+    (field_operand<L> && (field_operand<R> || std::is_arithmetic_v<R>)) ||
+    (std::is_arithmetic_v<L> && field_operand<R>);
+
+template <typename L, typename R> requires field_binary_operands<L, R>
+auto operator+(const L& l, const R& r) { return make_binary<ExprAdd>(l, r); }
+
+template <typename L, typename R> requires field_binary_operands<L, R>
+auto operator-(const L& l, const R& r) { return make_binary<ExprSub>(l, r); }
+
+template <typename L, typename R> requires field_binary_operands<L, R>
+auto operator*(const L& l, const R& r) { return make_binary<ExprMul>(l, r); }
+
+template <typename L, typename R> requires field_binary_operands<L, R>
+auto operator/(const L& l, const R& r) { return make_binary<ExprDiv>(l, r); }
+
+template <field_operand A>
+auto operator-(const A& a) { return UnaryExpr<ExprNeg, expr_t<A>>(as_expr(a)); }
+
+template <field_operand L, field_operand R>
+auto dot(const L& l, const R& r) { return make_binary<ExprDot>(l, r); }
+
+template <field_operand L, field_operand R>
+auto cross(const L& l, const R& r) { return make_binary<ExprCross>(l, r); }
+
+template <field_operand A>
+auto mag(const A& a) { return UnaryExpr<ExprMag, expr_t<A>>(as_expr(a)); }
+
+
+
+// === Evaluation ===
+
+// Fused evaluation into caller-provided storage (e.g. an export buffer), out[0..size()).
+template <typename E>
+void evaluate_into(const FieldExpr<E>& expr, typename E::value_type* out, unsigned nthreads = 0) {
+    const E& e = expr.self();
+    const std::size_t n = e.size();
+    if (n == static_cast<std::size_t>(-1)) {
+        throw std::invalid_argument("evaluate_into: expression has no field operand");
+    }
+    parallel_for_chunks(n, apl_thread_count(n, nthreads), [&](std::size_t b, std::size_t end, unsigned) {
+        for (std::size_t i = b; i < end; ++i) out[i] = e[i];
+    });
+}
+
+// Evaluate into an existing Field (sizes must match).
+template <typename T, unsigned Dim, typename E>
+void assign(Field<T, Dim>& f, const FieldExpr<E>& expr, unsigned nthreads = 0) {
+    static_assert(std::is_convertible_v<typename E::value_type, T>,
+                  "assign: expression value type does not convert to the field type");
+    if (expr.self().size() != f.data.size()) {
+        throw std::invalid_argument("assign: expression size does not match field '" + f.field_ID + "'");
+    }
+    if constexpr (std::is_same_v<typename E::value_type, T>) {
+        evaluate_into(expr, f.data.data(), nthreads);
+    } else {
+        const E& e = expr.self();
+        for (std::size_t i = 0; i < f.data.size(); ++i) f.data[i] = static_cast<T>(e[i]);
+    }
+}
+
+// Type-erased, lazily evaluated derived field. Holds the expression (by value, the
+// leaves point at the source fields) and evaluates only when asked.
+template <typename T>
+class LazyField {
+    std::function<void(T*, unsigned)> m_eval;
+    std::size_t m_size = 0;
+
+public:
+    using value_type = T;
+    std::string field_ID;
+
+    LazyField() = default;
+
+    template <typename E>
+    LazyField(std::string name, const FieldExpr<E>& expr)
+        : m_size(expr.self().size()), field_ID(std::move(name)) {
+        static_assert(std::is_same_v<typename E::value_type, T>,
+                      "LazyField<T>: expression value type must be T");
+        m_eval = [e = expr.self()](T* out, unsigned nthreads) { ::evaluate_into(e, out, nthreads); };
+    }
+
+    bool empty() const noexcept { return !m_eval; }
+    std::size_t size() const noexcept { return m_size; }
+
+    // Evaluate into caller storage of at least size() elements.
+    void evaluate_into(T* out, unsigned nthreads = 0) const {
+        if (!m_eval) throw std::logic_error("LazyField '" + field_ID + "' has no expression");
+        m_eval(out, nthreads);
+    }
+
+    std::vector<T> materialize(unsigned nthreads = 0) const {
+        std::vector<T> out(m_size);
+        evaluate_into(out.data(), nthreads);
+        return out;
+    }
+};
+
+// Deduce T from the expression: auto absE = make_lazy("absE", mag(E));
+template <typename E>
+LazyField<typename E::value_type> make_lazy(std::string name, const FieldExpr<E>& expr) {
+    return LazyField<typename E::value_type>(std::move(name), expr);
+}
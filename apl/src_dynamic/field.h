@@ -1,14 +1,26 @@
 #pragma once
 #include "bpl.h"
+#include "descriptor.h"
 
 class Field_b{
     public:
     std::string field_ID;
+    std::uint64_t version = 0;     // bumped by touch() whenever the data changes
     virtual ~Field_b() = default;  // Make it polymorphic
+
+    void touch() noexcept { ++version; }
     
     virtual size_t getTypeHash() const = 0;
     virtual size_t getDim() const = 0;
 
+    // Zero-copy description of the storage (pointer, dtype, components, extents, strides).
+    // The descriptor's `owner` expires when this field is destroyed.
+    virtual DataDescriptor describe() const = 0;
+
+    protected:
+    LifetimeToken lifetime;
+    public:
+
     // virtual needed to enforce call to child implementation  ??? getData() const = 0;  // What return type to use?
     // std::array<T, Dim> getData() const override {  // ERROR: can't change return type and don't know template   
     // Certain functions will be type relevant, and can't be declared inside virtul field_b
@@ -41,6 +53,12 @@ class Field : public Field_b{
     size_t getDim() const override {
         return Dim;
     }
+
+    DataDescriptor describe() const override {
+        DataDescriptor d = describe_contiguous(data.data(), static_cast<std::int64_t>(data.size()));
+        d.owner = lifetime.weak();
+        return d;
+    }
     
     const std::array<T, Dim>& getData() const { return data; }
     std::array<T, Dim>& getData() { return data; }
@@ -0,0 +1,140 @@
+#pragma once
+#include "Vis_forward.h"
+#include "parallel.h"
+#include "shape.h"
+
+// Needs GridField and ParticleSoA complete: include via bpl.h.
+
+// Grid-to-particle interpolation (gather) with NGP / CIC / TSC shapes, the transpose of
+// deposit.h: every particle gets the sum over its stencil of shape weight x field value.
+// - The field is a GridField<T,Dim>, T scalar or vec<S,N>; the result goes to the particle
+//   attribute column `column` (N components of S), which is added if missing.
+// - Positions must lie inside the field's owned cells. CIC and TSC read one ghost layer,
+//   so fill the ghosts (halo exchange) before gathering.
+// - Particles are processed in blocks of gather_block: one pass computes the weights and
+//   the linear base cell of the whole block into small SoA arrays, then every stencil
+//   point is one loop over the block (weight product, indexed load, multiply-add). Neither
+//   loop carries a dependency between particles, so both vectorize (the loads as gathers
+//   on AVX2 / AVX-512). Blocks are chunked over threads.
+// - After sort_particles (shape.h) the stencil reads of a block stay within a few tiles.
+
+inline constexpr std::size_t gather_block = 64;
+
+struct GatherOptions {
+    Shape shape = Shape::CIC;
+    unsigned nthreads = 0;      // 0: hardware
+};
+
+namespace gather_detail {
+
+template <Shape S, typename Particles, typename T, unsigned Dim>
+void gather_shape(const GridField<T, Dim>& f, Particles& p, const GridMap<Dim>& map, std::size_t column,
+                  unsigned nthreads) {
+    using R = scalar_type_t<T>;
+    constexpr unsigned N = vector_dimension_v<T>;
+    static_assert(sizeof(T) == sizeof(R) * N, "gather: field element type is not densely packed");
+    using W = ShapeWeights<S>;
+    constexpr int K = W::support;
+    constexpr std::size_t points = [] {
+        std::size_t q = 1;
+        for (unsigned a = 0; a < Dim; ++a) q *= K;
+        return q;
+    }();
+
+    // stencil point q: offset k[q][a] per axis, linear offset off[q]
+    std::array<std::array<int, Dim>, points> k{};
+    std::array<std::ptrdiff_t, points> off{};
+    std::array<std::ptrdiff_t, Dim> stride{};
+    for (unsigned a = 0; a < Dim; ++a) stride[a] = static_cast<std::ptrdiff_t>(f.stride(a));
+    for (std::size_t q = 0; q < points; ++q) {
+        std::size_t r = q;
+        for (unsigned a = 0; a < Dim; ++a) {
+            k[q][a] = static_cast<int>(r % K);
+            r /= K;
+            off[q] += k[q][a] * stride[a];
+        }
+    }
+
+    const R* field = reinterpret_cast<const R*>(f.values.data());
+    const auto ghost = static_cast<std::ptrdiff_t>(f.ghost);
+    std::array<const typename Particles::value_type*, Dim> x;
+    for (unsigned a = 0; a < Dim; ++a) x[a] = p.pos(a);
+    std::array<R*, N> out;
+    for (unsigned c = 0; c < N; ++c) out[c] = p.template data<R>(column, c);
+
+    const std::size_t n = p.size();
+    const std::size_t nblocks = (n + gather_block - 1) / gather_block;
+    const unsigned nt = std::min<unsigned>(apl_thread_count(n, nthreads),
+                                           static_cast<unsigned>(std::max<std::size_t>(nblocks, 1)));
+    parallel_for_chunks(nblocks, nt, [&](std::size_t bb, std::size_t be, unsigned) {
+        double w[Dim][K][gather_block];
+        std::ptrdiff_t base[gather_block];
+        double acc[N][gather_block];
+        for (std::size_t blk = bb; blk < be; ++blk) {
+            const std::size_t i0 = blk * gather_block;
+            const std::size_t m = std::min(gather_block, n - i0);
+
+            for (std::size_t i = 0; i < m; ++i) base[i] = 0;
+            for (unsigned a = 0; a < Dim; ++a) {
+                const auto* xa = x[a] + i0;
+                for (std::size_t i = 0; i < m; ++i) {
+                    const double xi = map.cell_coord(a, static_cast<double>(xa[i]));
+                    std::ptrdiff_t lo;
+                    double wa[K];
+                    W::eval(xi, lo, wa);
+                    for (int j = 0; j < K; ++j) w[a][j][i] = wa[j];
+                    base[i] += (lo + ghost) * stride[a];
+                }
+            }
+
+            for (unsigned c = 0; c < N; ++c) {
+                for (std::size_t i = 0; i < m; ++i) acc[c][i] = 0.0;
+            }
+            for (std::size_t q = 0; q < points; ++q) {
+                const R* fq = field + off[q] * static_cast<std::ptrdiff_t>(N);
+                const double* wq[Dim];
+                for (unsigned a = 0; a < Dim; ++a) wq[a] = w[a][k[q][a]];
+                for (std::size_t i = 0; i < m; ++i) {
+                    double wt = wq[0][i];
+                    for (unsigned a = 1; a < Dim; ++a) wt *= wq[a][i];
+                    const R* v = fq + base[i] * static_cast<std::ptrdiff_t>(N);
+                    for (unsigned c = 0; c < N; ++c) acc[c][i] += wt * static_cast<double>(v[c]);
+                }
+            }
+            for (unsigned c = 0; c < N; ++c) {
+                for (std::size_t i = 0; i < m; ++i) out[c][i0 + i] = static_cast<R>(acc[c][i]);
+            }
+        }
+    });
+}
+
+}  // namespace gather_detail
+
+// Interpolate `f` at the particle positions of `p` into the attribute column `column`.
+template <typename T, unsigned Dim, typename Particles>
+void gather(const GridField<T, Dim>& f, Particles& p, const GridMap<Dim>& map, const std::string& column,
+            const GatherOptions& o = {}) {
+    using R = scalar_type_t<T>;
+    constexpr unsigned N = vector_dimension_v<T>;
+    static_assert(std::is_arithmetic_v<R>, "gather: scalar or vec fields of arithmetic type");
+    static_assert(Particles::dim == Dim, "gather: particle and grid dimensions differ");
+    if (f.ghost < shape_reach(o.shape)) {
+        throw std::invalid_argument("gather: " + std::string(shape_name(o.shape)) + " needs ghost >= " +
+                                    std::to_string(shape_reach(o.shape)) + " on '" + f.field_ID + "'");
+    }
+
+    std::size_t c = p.find(column);
+    if (c == Particles::npos) {
+        c = p.template add_attribute<R>(column, N);
+    } else if (p.column(c).components != N) {
+        throw std::invalid_argument("gather: column '" + column + "' has " + std::to_string(p.column(c).components) +
+                                    " components, field '" + f.field_ID + "' " + std::to_string(N));
+    }
+
+    switch (o.shape) {
+        case Shape::NGP: gather_detail::gather_shape<Shape::NGP>(f, p, map, c, o.nthreads); break;
+        case Shape::CIC: gather_detail::gather_shape<Shape::CIC>(f, p, map, c, o.nthreads); break;
+        case Shape::TSC: gather_detail::gather_shape<Shape::TSC>(f, p, map, c, o.nthreads); break;
+    }
+    p.touch();
+}
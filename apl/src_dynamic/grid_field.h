@@ -0,0 +1,93 @@
+#pragma once
+#include "Vis_forward.h"
+#include "descriptor.h"
+
+#include <algorithm>
+
+// Needs Field_b complete: include via bpl.h.
+
+// Grid-backed field with runtime extents and ghost layers.
+// - `extents` are the owned cells per axis; `ghost` layers surround them on every side,
+//   so the storage is one contiguous block of (extents[a] + 2 ghost) per axis, axis 0
+//   fastest (the layout stencils, halo exchanges and deposition kernels work on).
+// - Indices are relative to the first owned cell: owned cells are 0 .. extents[a] - 1,
+//   ghost cells -ghost .. -1 and extents[a] .. extents[a] + ghost - 1.
+// - describe() covers the whole allocated block (owned + ghost cells); the mesh it is
+//   published on must span the same cells (mark the ghosts with vtkGhostType).
+
+template <typename T, unsigned Dim>
+class GridField : public Field_b {
+public:
+    using value_type = T;
+    using index_type = std::array<std::ptrdiff_t, Dim>;
+
+    std::array<std::size_t, Dim> extents{};
+    std::size_t ghost = 0;
+    std::vector<T> values;
+
+    GridField() { field_ID = "GridField_unlabeled"; }
+
+    GridField(std::string name, std::array<std::size_t, Dim> ext, std::size_t ghost_layers = 0, T init = T{})
+        : extents(ext), ghost(ghost_layers) {
+        field_ID = std::move(name);
+        std::size_t n = 1;
+        for (unsigned a = 0; a < Dim; ++a) n *= allocated(a);
+        values.assign(n, init);
+    }
+
+    std::size_t allocated(unsigned a) const noexcept { return extents[a] + 2 * ghost; }
+
+    // Element stride of axis a in the allocated block.
+    std::size_t stride(unsigned a) const noexcept {
+        std::size_t s = 1;
+        for (unsigned b = 0; b < a; ++b) s *= allocated(b);
+        return s;
+    }
+
+    std::size_t size() const noexcept { return values.size(); }
+
+    std::size_t owned_count() const noexcept {
+        std::size_t n = 1;
+        for (auto e : extents) n *= e;
+        return n;
+    }
+
+    // Linear index of cell idx (owned coordinates, ghosts negative / past the extent).
+    std::size_t index(const index_type& idx) const noexcept {
+        std::size_t l = 0, s = 1;
+        for (unsigned a = 0; a < Dim; ++a) {
+            l += static_cast<std::size_t>(idx[a] + static_cast<std::ptrdiff_t>(ghost)) * s;
+            s *= allocated(a);
+        }
+        return l;
+    }
+
+    template <typename... I>
+        requires(sizeof...(I) == Dim)
+    T& operator()(I... i) noexcept { return values[index({static_cast<std::ptrdiff_t>(i)...})]; }
+
+    template <typename... I>
+        requires(sizeof...(I) == Dim)
+    const T& operator()(I... i) const noexcept { return values[index({static_cast<std::ptrdiff_t>(i)...})]; }
+
+    T* data() noexcept { return values.data(); }
+    const T* data() const noexcept { return values.data(); }
+
+    void fill(const T& v) { std::fill(values.begin(), values.end(), v); }
+
+    size_t getTypeHash() const override { return typeid(T).hash_code(); }
+    size_t getDim() const override { return Dim; }
+
+    DataDescriptor describe() const override {
+        DataDescriptor d = describe_contiguous(values.data(), static_cast<std::int64_t>(values.size()));
+        d.ndim = Dim;
+        std::int64_t stride = static_cast<std::int64_t>(sizeof(T));
+        for (unsigned a = 0; a < Dim; ++a) {
+            d.extents[a] = static_cast<std::int64_t>(allocated(a));
+            d.strides[a] = stride;
+            stride *= d.extents[a];
+        }
+        d.owner = lifetime.weak();
+        return d;
+    }
+};
@@ -0,0 +1,304 @@
+#pragma once
+#include "Vis_forward.h"
+
+// Needs GridField complete: include via bpl.h. HaloExchange needs -DAPL_HAVE_MPI (the
+// options are always declared).
+
+// Ghost-cell (halo) exchange of a GridField<T,Dim> on an MPI Cartesian communicator
+// (cart axis a = field axis a, e.g. CartDecomp::cart in the mini apps).
+// - `width` ghost layers (<= field.ghost) are filled from the neighbours' owned boundary
+//   layers. With `corners` all 3^Dim - 1 neighbours take part, so edge and corner ghosts
+//   arrive in the same single round; without, only the 2 Dim face neighbours (enough for
+//   a 7-point stencil). Ghosts towards non-periodic walls are left untouched.
+// - Persistent requests (MPI_Send_init / MPI_Recv_init) are set up once; an exchange is
+//   MPI_Startall + MPI_Waitall.
+// - Strategies:
+//     Datatype  MPI_Type_create_subarray per region, MPI reads/writes the field directly
+//     Packed    regions copied row by row into contiguous per-neighbour buffers
+//   Which is faster depends on the MPI implementation and the network; bench_halo
+//   measures both.
+// - Split phase: begin() starts the exchange, end() completes it. Owned cells at least
+//   `width` cells away from every face read no ghost of a width-stencil, so they can be
+//   updated in between (calling test() now and then), the rest after end(). Neither the
+//   owned boundary layers nor the ghosts may be written between begin() and end().
+// - With Datatype the requests are tied to the storage address; a field whose storage is
+//   swapped (double-buffered Jacobi: std::swap(a.values, b.values)) gets one request set
+//   per buffer, created on first use.
+// - `accumulate` reverses the exchange for scatter operations (particle deposition): the
+//   ghost layers go to the neighbours, which add them into their owned boundary layers.
+//   The received layers always arrive in buffers (two-sided MPI cannot add on receive);
+//   with Datatype the ghosts are sent straight from the field. Use `corners` (default)
+//   so edge and corner ghosts reach the diagonal neighbours in the same round. Ghosts
+//   towards walls are not sent, and no ghost is cleared.
+// Destroy the exchange before MPI_Finalize.
+
+enum class HaloStrategy { Datatype, Packed };
+
+constexpr const char* halo_strategy_name(HaloStrategy s) {
+    return s == HaloStrategy::Datatype ? "datatype" : "packed";
+}
+
+struct HaloOptions {
+    std::size_t width = 0;      // ghost layers to exchange (0: all of the field's)
+    bool corners = true;        // edge/corner neighbours too, else faces only
+    bool accumulate = false;    // reverse: add the ghosts into the neighbours' owned layers
+    HaloStrategy strategy = HaloStrategy::Datatype;
+};
+
+#ifdef APL_HAVE_MPI
+#include <mpi.h>
+
+template <typename T, unsigned Dim>
+class HaloExchange {
+public:
+    HaloExchange(MPI_Comm cart, GridField<T, Dim>& f, const HaloOptions& o = {})
+        : m_field(f), m_comm(cart), m_opts(o) {
+        int topo = MPI_UNDEFINED, ndims = 0;
+        MPI_Topo_test(cart, &topo);
+        if (topo != MPI_CART) throw std::invalid_argument("HaloExchange: communicator has no Cartesian topology");
+        MPI_Cartdim_get(cart, &ndims);
+        if (ndims != static_cast<int>(Dim)) throw std::invalid_argument("HaloExchange: Cartesian dimensions differ");
+        m_width = o.width ? o.width : f.ghost;
+        if (m_width == 0 || m_width > f.ghost) {
+            throw std::invalid_argument("HaloExchange: width must be 1 .. ghost (" + std::to_string(f.ghost) +
+                                        ") on '" + f.field_ID + "'");
+        }
+
+        int dims[Dim], periods[Dim], coords[Dim];
+        MPI_Cart_get(cart, static_cast<int>(Dim), dims, periods, coords);
+        MPI_Type_contiguous(static_cast<int>(sizeof(T)), MPI_BYTE, &m_elem);
+        MPI_Type_commit(&m_elem);
+
+        constexpr int ndir = ipow3(Dim);
+        for (int q = 0; q < ndir; ++q) {
+            std::array<int, Dim> d{};
+            int nonzero = 0;
+            for (unsigned a = 0, r = static_cast<unsigned>(q); a < Dim; ++a, r /= 3) {
+                d[a] = static_cast<int>(r % 3) - 1;
+                nonzero += d[a] != 0;
+            }
+            if (nonzero == 0 || (!o.corners && nonzero > 1)) continue;
+
+            int nc[Dim];
+            bool wall = false;
+            for (unsigned a = 0; a < Dim; ++a) {
+                nc[a] = coords[a] + d[a];
+                if (nc[a] < 0 || nc[a] >= dims[a]) {
+                    if (periods[a]) nc[a] = (nc[a] + dims[a]) % dims[a];
+                    else wall = true;
+                }
+            }
+            if (wall) continue;
+
+            Neighbour n;
+            MPI_Cart_rank(cart, nc, &n.rank);
+            n.send_tag = q;
+            n.recv_tag = ndir - 1 - q;   // direction -d as seen from the neighbour
+            std::size_t count = 1;
+            for (unsigned a = 0; a < Dim; ++a) {
+                const auto w = static_cast<std::ptrdiff_t>(m_width);
+                const auto g = static_cast<std::ptrdiff_t>(f.ghost);
+                const auto e = static_cast<std::ptrdiff_t>(f.extents[a]);
+                if (d[a] != 0 && m_width > f.extents[a]) {
+                    throw std::invalid_argument("HaloExchange: width exceeds the owned cells of '" + f.field_ID + "'");
+                }
+                n.size[a] = d[a] == 0 ? e : w;
+                n.send_lo[a] = d[a] < 0 ? g : d[a] > 0 ? g + e - w : g;
+                n.recv_lo[a] = d[a] < 0 ? g - w : d[a] > 0 ? g + e : g;
+                count *= static_cast<std::size_t>(n.size[a]);
+            }
+            n.count = count;
+            if (o.strategy == HaloStrategy::Datatype) {
+                n.send_type = subarray(n.send_lo, n.size);
+                n.recv_type = subarray(n.recv_lo, n.size);
+            } else {
+                n.send_buf.resize(count * sizeof(T));
+            }
+            if (o.strategy == HaloStrategy::Packed || o.accumulate) n.recv_buf.resize(count * sizeof(T));
+            m_bytes += count * sizeof(T);
+            m_nbrs.push_back(std::move(n));
+        }
+        if (o.strategy == HaloStrategy::Packed) m_sets.push_back(make_requests(nullptr));
+    }
+
+    HaloExchange(const HaloExchange&) = delete;
+    HaloExchange& operator=(const HaloExchange&) = delete;
+
+    ~HaloExchange() {
+        if (m_active) end();
+        for (auto& s : m_sets) {
+            for (MPI_Request& r : s.requests) MPI_Request_free(&r);
+        }
+        for (auto& n : m_nbrs) {
+            if (n.send_type != MPI_DATATYPE_NULL) MPI_Type_free(&n.send_type);
+            if (n.recv_type != MPI_DATATYPE_NULL) MPI_Type_free(&n.recv_type);
+        }
+        MPI_Type_free(&m_elem);
+    }
+
+    // Start the exchange: pack (Packed), then start all receives and sends.
+    void begin() {
+        if (m_active) throw std::logic_error("HaloExchange: begin() while an exchange is in flight");
+        RequestSet& s = current();
+        if (m_opts.strategy == HaloStrategy::Packed) {
+            for (auto& n : m_nbrs) {
+                copy_region<Copy::Pack>(m_opts.accumulate ? n.recv_lo : n.send_lo, n.size, n.send_buf.data());
+            }
+        }
+        if (!s.requests.empty()) MPI_Startall(static_cast<int>(s.requests.size()), s.requests.data());
+        m_running = &s;
+        m_active = true;
+    }
+
+    // Complete the exchange: wait, unpack (Packed) or add (accumulate).
+    void end() {
+        if (!m_active) throw std::logic_error("HaloExchange: end() without begin()");
+        if (!m_running->requests.empty()) {
+            MPI_Waitall(static_cast<int>(m_running->requests.size()), m_running->requests.data(), MPI_STATUSES_IGNORE);
+        }
+        m_active = false;
+        if (m_opts.accumulate) {
+            for (auto& n : m_nbrs) copy_region<Copy::Add>(n.send_lo, n.size, n.recv_buf.data());
+        } else if (m_opts.strategy == HaloStrategy::Packed) {
+            for (auto& n : m_nbrs) copy_region<Copy::Unpack>(n.recv_lo, n.size, n.recv_buf.data());
+        }
+    }
+
+    // Drive progress while overlapping: many MPI libraries move large messages only inside
+    // MPI calls, so call this between chunks of interior work. True once all arrived;
+    // end() is still required.
+    bool test() {
+        if (!m_active) throw std::logic_error("HaloExchange: test() without begin()");
+        int done = 1;
+        if (!m_running->requests.empty()) {
+            MPI_Testall(static_cast<int>(m_running->requests.size()), m_running->requests.data(), &done,
+                        MPI_STATUSES_IGNORE);
+        }
+        return done != 0;
+    }
+
+    void exchange() {
+        begin();
+        end();
+    }
+
+    bool active() const noexcept { return m_active; }
+    std::size_t width() const noexcept { return m_width; }
+    std::size_t neighbours() const noexcept { return m_nbrs.size(); }
+    // Bytes sent (= received) by this rank per exchange.
+    std::size_t message_bytes() const noexcept { return m_bytes; }
+    const HaloOptions& options() const noexcept { return m_opts; }
+
+private:
+    struct Neighbour {
+        int rank = MPI_PROC_NULL;
+        int send_tag = 0, recv_tag = 0;
+        std::array<std::ptrdiff_t, Dim> send_lo{}, recv_lo{}, size{};   // allocated-block coordinates
+        std::size_t count = 0;                                          // elements per message
+        MPI_Datatype send_type = MPI_DATATYPE_NULL, recv_type = MPI_DATATYPE_NULL;
+        std::vector<std::byte> send_buf, recv_buf;
+    };
+
+    struct RequestSet {
+        const T* storage = nullptr;        // Datatype: field storage the requests point into
+        std::vector<MPI_Request> requests; // receives first, then sends
+    };
+
+    enum class Copy { Pack, Unpack, Add };
+
+    static constexpr int ipow3(unsigned n) { return n == 0 ? 1 : 3 * ipow3(n - 1); }
+
+    MPI_Datatype subarray(const std::array<std::ptrdiff_t, Dim>& lo, const std::array<std::ptrdiff_t, Dim>& size) const {
+        int sizes[Dim], sub[Dim], starts[Dim];
+        for (unsigned a = 0; a < Dim; ++a) {
+            sizes[a] = static_cast<int>(m_field.allocated(a));
+            sub[a] = static_cast<int>(size[a]);
+            starts[a] = static_cast<int>(lo[a]);
+        }
+        MPI_Datatype t;
+        // axis 0 fastest = Fortran order
+        MPI_Type_create_subarray(static_cast<int>(Dim), sizes, sub, starts, MPI_ORDER_FORTRAN, m_elem, &t);
+        MPI_Type_commit(&t);
+        return t;
+    }
+
+    RequestSet make_requests(const T* storage) {
+        RequestSet s;
+        s.storage = storage;
+        s.requests.resize(2 * m_nbrs.size());
+        for (std::size_t i = 0; i < m_nbrs.size(); ++i) {
+            Neighbour& n = m_nbrs[i];
+            MPI_Request* r = &s.requests[i];
+            MPI_Request* w = &s.requests[m_nbrs.size() + i];
+            if (m_opts.strategy == HaloStrategy::Datatype && m_opts.accumulate) {
+                MPI_Recv_init(n.recv_buf.data(), static_cast<int>(n.recv_buf.size()), MPI_BYTE, n.rank, n.recv_tag,
+                              m_comm, r);
+                MPI_Send_init(const_cast<T*>(storage), 1, n.recv_type, n.rank, n.send_tag, m_comm, w);
+            } else if (m_opts.strategy == HaloStrategy::Datatype) {
+                void* base = const_cast<T*>(storage);
+                MPI_Recv_init(base, 1, n.recv_type, n.rank, n.recv_tag, m_comm, r);
+                MPI_Send_init(base, 1, n.send_type, n.rank, n.send_tag, m_comm, w);
+            } else {
+                MPI_Recv_init(n.recv_buf.data(), static_cast<int>(n.recv_buf.size()), MPI_BYTE, n.rank, n.recv_tag,
+                              m_comm, r);
+                MPI_Send_init(n.send_buf.data(), static_cast<int>(n.send_buf.size()), MPI_BYTE, n.rank, n.send_tag,
+                              m_comm, w);
+            }
+        }
+        return s;
+    }
+
+    RequestSet& current() {
+        if (m_opts.strategy == HaloStrategy::Packed) return m_sets.front();
+        const T* storage = m_field.data();
+        for (auto& s : m_sets) {
+            if (s.storage == storage) return s;
+        }
+        m_sets.push_back(make_requests(storage));
+        return m_sets.back();
+    }
+
+    // Pack, unpack or add the region [lo, lo + size) of the allocated block, rows of axis 0.
+    template <Copy Mode>
+    void copy_region(const std::array<std::ptrdiff_t, Dim>& lo, const std::array<std::ptrdiff_t, Dim>& size,
+                     std::byte* buf) {
+        T* base = m_field.data();
+        const std::size_t row = static_cast<std::size_t>(size[0]) * sizeof(T);
+        std::size_t rows = 1;
+        for (unsigned a = 1; a < Dim; ++a) rows *= static_cast<std::size_t>(size[a]);
+        for (std::size_t r = 0; r < rows; ++r) {
+            std::size_t off = static_cast<std::size_t>(lo[0]);
+            std::size_t q = r;
+            for (unsigned a = 1; a < Dim; ++a) {
+                const std::size_t c = q % static_cast<std::size_t>(size[a]);
+                q /= static_cast<std::size_t>(size[a]);
+                off += (static_cast<std::size_t>(lo[a]) + c) * m_field.stride(a);
+            }
+            if constexpr (Mode == Copy::Pack) {
+                std::memcpy(buf + r * row, base + off, row);
+            } else if constexpr (Mode == Copy::Unpack) {
+                std::memcpy(base + off, buf + r * row, row);
+            } else {
+                // component-wise, so vec<S,N> elements need no operator+=
+                using R = scalar_type_t<T>;
+                const std::size_t m = static_cast<std::size_t>(size[0]) * vector_dimension_v<T>;
+                R* to = reinterpret_cast<R*>(base + off);
+                const R* from = reinterpret_cast<const R*>(buf + r * row);
+                for (std::size_t i = 0; i < m; ++i) to[i] += from[i];
+            }
+        }
+    }
+
+    GridField<T, Dim>& m_field;
+    MPI_Comm m_comm;
+    HaloOptions m_opts;
+    std::size_t m_width = 0;
+    std::size_t m_bytes = 0;
+    MPI_Datatype m_elem = MPI_DATATYPE_NULL;
+    std::vector<Neighbour> m_nbrs;
+    std::vector<RequestSet> m_sets;
+    RequestSet* m_running = nullptr;
+    bool m_active = false;
+};
+
+#endif  // APL_HAVE_MPI
@@ -0,0 +1,226 @@
+// Halo exchange bandwidth and communication/computation overlap (halo.h). MPI program.
+//
+// Every rank owns a cube of `cells`^3 doubles with `width` ghost layers on a periodic 3D
+// process grid (MPI_Dims_create), so every rank has all neighbours.
+// - bandwidth: exchange() per strategy (datatype / packed) with faces only and with edges
+//   and corners; time per exchange is the slowest rank's mean over `reps`, bandwidth the
+//   bytes one rank sends per exchange divided by it. Every ghost is checked against the
+//   neighbour's owned value after the first exchange.
+// - overlap: `reps` Jacobi sweeps of a 7-point average (faces, double-buffered) with
+//     compute   no exchange at all (lower bound)
+//     blocking  exchange(), then all owned cells
+//     overlap   begin(), interior cells (test() every 8 planes), end(), boundary shell
+//   "hidden" is the share of the exchange time that the overlap version no longer pays:
+//   (blocking - overlap) / (blocking - compute). Both versions must give the same field.
+//
+// Usage: mpiexec -n 8 ./bild/halo_bench [cells=64] [width=1] [reps=50]
+
+constexpr unsigned Dim = 3;
+using T = double;
+#include "bpl.h"
+
+#ifndef APL_HAVE_MPI
+#error "halo_bench needs MPI: build with mpicxx -DAPL_HAVE_MPI (make bench_halo)"
+#endif
+
+#include <iomanip>
+
+using Grid = GridField<double, 3>;
+using Box = std::array<std::array<std::ptrdiff_t, 2>, 3>;   // owned-cell ranges [lo, hi) per axis
+
+struct Setup {
+    MPI_Comm cart = MPI_COMM_NULL;
+    int rank = 0, size = 1;
+    int dims[3] = {0, 0, 0}, coords[3] = {0, 0, 0};
+    std::size_t cells = 64;
+};
+
+// Value of global cell g (periodic), unique per cell.
+static double tag_of(const Setup& s, std::array<std::ptrdiff_t, 3> g) {
+    double v = 0.0, scale = 1.0;
+    for (int a = 0; a < 3; ++a) {
+        const auto n = static_cast<std::ptrdiff_t>(s.cells) * s.dims[a];
+        v += static_cast<double>(((g[a] % n) + n) % n) * scale;
+        scale *= static_cast<double>(n);
+    }
+    return v;
+}
+
+static std::array<std::ptrdiff_t, 3> global_of(const Setup& s, std::ptrdiff_t i, std::ptrdiff_t j, std::ptrdiff_t k) {
+    const auto n = static_cast<std::ptrdiff_t>(s.cells);
+    return {s.coords[0] * n + i, s.coords[1] * n + j, s.coords[2] * n + k};
+}
+
+// Ghost cells that an exchange with (corners) fills and that differ from the owner's value.
+static long check_ghosts(const Setup& s, const Grid& f, std::size_t width, bool corners) {
+    const auto n = static_cast<std::ptrdiff_t>(s.cells), w = static_cast<std::ptrdiff_t>(width);
+    long bad = 0;
+    for (std::ptrdiff_t k = -w; k < n + w; ++k)
+        for (std::ptrdiff_t j = -w; j < n + w; ++j)
+            for (std::ptrdiff_t i = -w; i < n + w; ++i) {
+                const int outside = (i < 0 || i >= n) + (j < 0 || j >= n) + (k < 0 || k >= n);
+                if (outside == 0 || (!corners && outside > 1)) continue;
+                bad += f(i, j, k) != tag_of(s, global_of(s, i, j, k));
+            }
+    return bad;
+}
+
+// 7-point average of `in` into `out` over the owned cells of `b`.
+static void sweep(const Grid& in, Grid& out, const Box& b) {
+    const std::size_t sy = in.stride(1), sz = in.stride(2);
+    const double* p = in.data();
+    double* q = out.data();
+    for (std::ptrdiff_t k = b[2][0]; k < b[2][1]; ++k)
+        for (std::ptrdiff_t j = b[1][0]; j < b[1][1]; ++j) {
+            const std::size_t c0 = in.index({0, j, k});
+            for (std::ptrdiff_t i = b[0][0]; i < b[0][1]; ++i) {
+                const std::size_t c = c0 + static_cast<std::size_t>(i);
+                q[c] = (p[c - 1] + p[c + 1] + p[c - sy] + p[c + sy] + p[c - sz] + p[c + sz]) / 6.0;
+            }
+        }
+}
+
+// The owned cells at distance < r from a face, as disjoint boxes.
+static std::vector<Box> shell(std::ptrdiff_t n, std::ptrdiff_t r) {
+    std::vector<Box> boxes;
+    for (int a = 2; a >= 0; --a) {
+        for (const auto side : {std::array<std::ptrdiff_t, 2>{0, r}, std::array<std::ptrdiff_t, 2>{n - r, n}}) {
+            Box b;
+            for (int c = 0; c < 3; ++c) b[c] = c < a ? std::array<std::ptrdiff_t, 2>{0, n}
+                                                     : std::array<std::ptrdiff_t, 2>{r, n - r};
+            b[a] = side;
+            boxes.push_back(b);
+        }
+    }
+    return boxes;
+}
+
+static double max_over_ranks(double v, MPI_Comm comm) {
+    MPI_Allreduce(MPI_IN_PLACE, &v, 1, MPI_DOUBLE, MPI_MAX, comm);
+    return v;
+}
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+    Setup s;
+    s.cells = argc > 1 ? std::stoull(argv[1]) : 64;
+    const std::size_t width = argc > 2 ? std::stoull(argv[2]) : 1;
+    const int reps = argc > 3 ? std::stoi(argv[3]) : 50;
+    MPI_Comm_rank(MPI_COMM_WORLD, &s.rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &s.size);
+    MPI_Dims_create(s.size, 3, s.dims);
+    const int periods[3] = {1, 1, 1};
+    MPI_Cart_create(MPI_COMM_WORLD, 3, s.dims, periods, 0, &s.cart);
+    MPI_Cart_coords(s.cart, s.rank, 3, s.coords);
+    const auto n = static_cast<std::ptrdiff_t>(s.cells);
+
+    Grid u("u", {s.cells, s.cells, s.cells}, width), v("v", {s.cells, s.cells, s.cells}, width);
+    auto init = [&](Grid& f) {
+        f.fill(-1.0);
+        for (std::ptrdiff_t k = 0; k < n; ++k)
+            for (std::ptrdiff_t j = 0; j < n; ++j)
+                for (std::ptrdiff_t i = 0; i < n; ++i) f(i, j, k) = tag_of(s, global_of(s, i, j, k));
+    };
+
+    if (s.rank == 0) {
+        std::cout << "ranks: " << s.size << " (" << s.dims[0] << "x" << s.dims[1] << "x" << s.dims[2]
+                  << ", periodic), cells/rank: " << s.cells << "^3, width: " << width << ", reps: " << reps << "\n\n"
+                  << std::left << std::setw(10) << "strategy" << std::setw(9) << "stencil" << std::right
+                  << std::setw(11) << "neighbours" << std::setw(12) << "KiB/exch" << std::setw(12) << "us/exch"
+                  << std::setw(10) << "MB/s" << std::setw(8) << "check" << "\n";
+    }
+    for (HaloStrategy strategy : {HaloStrategy::Datatype, HaloStrategy::Packed}) {
+        for (bool corners : {false, true}) {
+            init(u);
+            HaloOptions o;
+            o.width = width;
+            o.corners = corners;
+            o.strategy = strategy;
+            HaloExchange<double, 3> halo(s.cart, u, o);
+            halo.exchange();
+            long bad = check_ghosts(s, u, width, corners);
+            MPI_Allreduce(MPI_IN_PLACE, &bad, 1, MPI_LONG, MPI_SUM, s.cart);
+            for (int r = 0; r < 3; ++r) halo.exchange();
+
+            MPI_Barrier(s.cart);
+            const double t0 = MPI_Wtime();
+            for (int r = 0; r < reps; ++r) halo.exchange();
+            const double t = max_over_ranks((MPI_Wtime() - t0) / reps, s.cart);
+            if (s.rank == 0) {
+                const double bytes = static_cast<double>(halo.message_bytes());
+                std::cout << std::left << std::setw(10) << halo_strategy_name(strategy) << std::setw(9)
+                          << (corners ? "27-pt" : "7-pt") << std::right << std::setw(11) << halo.neighbours()
+                          << std::setw(12) << std::fixed << std::setprecision(1) << bytes / 1024.0 << std::setw(12)
+                          << 1e6 * t << std::setw(10) << std::setprecision(0) << bytes / t * 1e-6 << std::setw(8)
+                          << (bad == 0 ? "ok" : "FAIL") << "\n";
+            }
+        }
+    }
+
+    // overlap: Jacobi sweeps, faces only
+    const Box all{{{0, n}, {0, n}, {0, n}}};
+    const Box interior{{{1, n - 1}, {1, n - 1}, {1, n - 1}}};
+    const std::vector<Box> boundary = shell(n, 1);
+    std::vector<Box> slabs;   // interior in k-slabs, test() in between
+    for (std::ptrdiff_t k = 1; k < n - 1; k += 8) {
+        Box b = interior;
+        b[2] = {k, std::min(k + 8, n - 1)};
+        slabs.push_back(b);
+    }
+    auto run = [&](int mode, HaloStrategy strategy) {
+        init(u);
+        init(v);
+        HaloOptions o;
+        o.width = width;
+        o.corners = false;
+        o.strategy = strategy;
+        HaloExchange<double, 3> halo(s.cart, u, o);
+        MPI_Barrier(s.cart);
+        const double t0 = MPI_Wtime();
+        for (int r = 0; r < reps; ++r) {
+            if (mode == 0) {
+                sweep(u, v, all);
+            } else if (mode == 1) {
+                halo.exchange();
+                sweep(u, v, all);
+            } else {
+                halo.begin();
+                for (const Box& b : slabs) {
+                    sweep(u, v, b);
+                    halo.test();
+                }
+                halo.end();
+                for (const Box& b : boundary) sweep(u, v, b);
+            }
+            std::swap(u.values, v.values);
+        }
+        return max_over_ranks((MPI_Wtime() - t0) / reps, s.cart);
+    };
+
+    if (s.rank == 0) {
+        std::cout << "\nJacobi sweep (7-pt, faces): ms/step\n"
+                  << std::left << std::setw(10) << "strategy" << std::right << std::setw(10) << "compute"
+                  << std::setw(10) << "blocking" << std::setw(10) << "overlap" << std::setw(9) << "hidden"
+                  << std::setw(12) << "max diff" << "\n";
+    }
+    for (HaloStrategy strategy : {HaloStrategy::Datatype, HaloStrategy::Packed}) {
+        const double tc = run(0, strategy);
+        const double tb = run(1, strategy);
+        const std::vector<double> blocking = u.values;
+        const double to = run(2, strategy);
+        double diff = 0.0;
+        for (std::size_t i = 0; i < blocking.size(); ++i) diff = std::max(diff, std::abs(blocking[i] - u.values[i]));
+        diff = max_over_ranks(diff, s.cart);
+        if (s.rank == 0) {
+            const double hidden = tb > tc ? (tb - to) / (tb - tc) : 0.0;
+            std::cout << std::left << std::setw(10) << halo_strategy_name(strategy) << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(10) << 1e3 * tc << std::setw(10) << 1e3 * tb
+                      << std::setw(10) << 1e3 * to << std::setw(8) << std::setprecision(0) << 100.0 * hidden << "%"
+                      << std::setw(12) << std::scientific << std::setprecision(1) << diff << std::fixed << "\n";
+        }
+    }
+
+    MPI_Comm_free(&s.cart);
+    MPI_Finalize();
+    return 0;
+}
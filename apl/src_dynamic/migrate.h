@@ -0,0 +1,393 @@
+#pragma once
+#include "Vis_forward.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Needs ParticleSoA complete: include via bpl.h. ParticleMigration needs -DAPL_HAVE_MPI (the
+// options are always declared).
+
+// Migration of ParticleSoA particles to the rank owning their position (after a push).
+// The ranks form an MPI Cartesian process grid of blocks; planes[a] holds the dims[a] + 1
+// increasing block boundaries along axis a, so the global box is [front, back) per axis.
+// - Classification: one branch-free pass per axis compares the positions against the
+//   owned box and against the outer bounds of the neighbour blocks, into one byte per
+//   particle: the direction (0 .. 3^Dim - 1, centre: stays) or `far` (past a neighbour
+//   block). Only the leavers are touched afterwards.
+// - Packing: leavers are grouped by destination, and every component of every column is
+//   gathered into the destination's block of one send buffer. The message is SoA too, so
+//   the receiver appends each component with a single memcpy. Columns are copied by scalar
+//   size (ParticleSoA::raw), without knowing their types.
+// - Exchange: normally only the neighbours talk (counts, then data; MPI_Isend/Irecv). If
+//   any rank holds a far particle (one MPI_Allreduce per call decides), that call falls
+//   back to MPI_Alltoall + MPI_Alltoallv over all ranks. MigrationMode::AllToAll always
+//   takes the fallback (for comparison).
+// - Stayers are compacted in place (order kept), arrivals are appended. Towards
+//   non-periodic walls the owned box is unbounded, so particles outside the global box
+//   stay with the boundary rank; across periodic boundaries the receiver wraps positions.
+
+enum class MigrationMode { Auto, AllToAll };
+
+constexpr const char* migration_mode_name(MigrationMode m) {
+    return m == MigrationMode::Auto ? "auto" : "alltoall";
+}
+
+struct MigrationOptions {
+    MigrationMode mode = MigrationMode::Auto;
+    unsigned nthreads = 0;      // 0: hardware
+};
+
+struct MigrationStats {
+    std::size_t sent = 0, received = 0;
+    bool all_to_all = false;    // this call took the all-to-all path
+};
+
+#ifdef APL_HAVE_MPI
+#include <mpi.h>
+
+template <typename T, unsigned Dim>
+class ParticleMigration {
+    static_assert(Dim >= 1 && Dim <= 4, "ParticleMigration: 1 to 4 dimensions (directions are bytes)");
+
+public:
+    using Particles = ParticleSoA<T, Dim>;
+
+    ParticleMigration(MPI_Comm cart, const std::array<std::vector<double>, Dim>& planes, const MigrationOptions& o = {})
+        : m_comm(cart), m_planes(planes), m_opts(o) {
+        int topo = MPI_UNDEFINED, ndims = 0;
+        MPI_Topo_test(cart, &topo);
+        if (topo != MPI_CART) throw std::invalid_argument("ParticleMigration: communicator has no Cartesian topology");
+        MPI_Cartdim_get(cart, &ndims);
+        if (ndims != static_cast<int>(Dim)) throw std::invalid_argument("ParticleMigration: Cartesian dimensions differ");
+
+        int dims[Dim], periods[Dim], coords[Dim];
+        MPI_Cart_get(cart, static_cast<int>(Dim), dims, periods, coords);
+        constexpr double inf = std::numeric_limits<double>::infinity();
+        for (unsigned a = 0; a < Dim; ++a) {
+            const std::vector<double>& p = planes[a];
+            if (p.size() != static_cast<std::size_t>(dims[a]) + 1) {
+                throw std::invalid_argument("ParticleMigration: axis " + std::to_string(a) + " needs " +
+                                            std::to_string(dims[a] + 1) + " planes, got " + std::to_string(p.size()));
+            }
+            for (std::size_t j = 1; j < p.size(); ++j) {
+                if (!(p[j] > p[j - 1])) throw std::invalid_argument("ParticleMigration: planes must increase");
+            }
+            const auto c = static_cast<std::size_t>(coords[a]);
+            const std::size_t last = p.size() - 1;
+            m_dims[a] = dims[a];
+            m_periodic[a] = periods[a] != 0;
+            m_lo[a] = p[c];
+            m_hi[a] = p[c + 1];
+            // outer bounds of the neighbour blocks; unbounded towards walls
+            if (c > 0) m_reach_lo[a] = p[c - 1];
+            else if (m_periodic[a]) m_reach_lo[a] = m_lo[a] - (p[last] - p[last - 1]);
+            else m_lo[a] = m_reach_lo[a] = -inf;
+            if (c + 1 < last) m_reach_hi[a] = p[c + 2];
+            else if (m_periodic[a]) m_reach_hi[a] = m_hi[a] + (p[1] - p[0]);
+            else m_hi[a] = m_reach_hi[a] = inf;
+        }
+
+        for (int q = 0; q < ndir; ++q) {
+            m_rank_of[q] = MPI_PROC_NULL;
+            m_slot_of[q] = -1;
+            if (q == centre) continue;
+            int nc[Dim];
+            bool wall = false;
+            for (unsigned a = 0, r = static_cast<unsigned>(q); a < Dim; ++a, r /= 3) {
+                nc[a] = coords[a] + static_cast<int>(r % 3) - 1;
+                if (nc[a] < 0 || nc[a] >= dims[a]) {
+                    if (periods[a]) nc[a] = (nc[a] + dims[a]) % dims[a];
+                    else wall = true;
+                }
+            }
+            if (wall) continue;
+            MPI_Cart_rank(cart, nc, &m_rank_of[q]);
+            m_slot_of[q] = static_cast<int>(m_nbrs.size());
+            m_nbrs.push_back(q);
+        }
+    }
+
+    // Send every particle of `p` that left the owned box to its owner; append the arrivals.
+    // Collective over the communicator.
+    MigrationStats migrate(Particles& p) {
+        MigrationStats stats;
+        const int far = classify(p);
+        int any_far = far;
+        if (m_opts.mode == MigrationMode::Auto) MPI_Allreduce(&far, &any_far, 1, MPI_INT, MPI_LOR, m_comm);
+        stats.all_to_all = m_opts.mode == MigrationMode::AllToAll || any_far != 0;
+
+        int size = 1;
+        MPI_Comm_size(m_comm, &size);
+        const std::size_t nslots = stats.all_to_all ? static_cast<std::size_t>(size) : m_nbrs.size();
+        group(p, nslots, stats.all_to_all);
+
+        // one record per particle: every component of every column
+        m_comps.clear();
+        std::size_t record = 0;
+        for (std::size_t c = 0; c < p.num_columns(); ++c) {
+            const auto& col = p.column(c);
+            for (unsigned k = 0; k < col.components; ++k) {
+                m_comps.push_back(Component{c, k, col.scalar_bytes, record});
+                record += col.scalar_bytes;
+            }
+        }
+        pack(p, record);
+
+        MPI_Datatype rec;
+        MPI_Type_contiguous(static_cast<int>(record), MPI_BYTE, &rec);
+        MPI_Type_commit(&rec);
+        if (stats.all_to_all) exchange_all(rec, record, size);
+        else exchange_neighbours(rec, record);
+        MPI_Type_free(&rec);
+
+        stats.sent = m_leave.size();
+        stats.received = m_roffset.back();
+        unpack(p, record);
+        return stats;
+    }
+
+    // Rank owning position x (wrapped on periodic axes, clamped to the edge blocks otherwise).
+    int owner(const std::array<double, Dim>& x) const {
+        int c[Dim];
+        for (unsigned a = 0; a < Dim; ++a) {
+            const std::vector<double>& p = m_planes[a];
+            const double v = m_periodic[a] ? wrap(a, x[a]) : x[a];
+            const auto j = std::upper_bound(p.begin(), p.end(), v) - p.begin() - 1;
+            c[a] = static_cast<int>(std::clamp<std::ptrdiff_t>(j, 0, m_dims[a] - 1));
+        }
+        int r = MPI_PROC_NULL;
+        MPI_Cart_rank(m_comm, c, &r);
+        return r;
+    }
+
+    // Owned box of this rank (+-inf towards non-periodic walls).
+    double lo(unsigned a) const { return m_lo[a]; }
+    double hi(unsigned a) const { return m_hi[a]; }
+    std::size_t neighbours() const noexcept { return m_nbrs.size(); }
+    const MigrationOptions& options() const noexcept { return m_opts; }
+
+private:
+    static constexpr int ipow3(unsigned n) { return n == 0 ? 1 : 3 * ipow3(n - 1); }
+    static constexpr int ndir = ipow3(Dim);
+    static constexpr int centre = (ndir - 1) / 2;
+    static constexpr std::uint8_t far_code = 0xff;
+
+    struct Component {
+        std::size_t column;
+        unsigned k;
+        std::size_t bytes;      // scalar size
+        std::size_t offset;     // bytes before this component in a record
+    };
+
+    double wrap(unsigned a, double x) const {
+        const double front = m_planes[a].front(), back = m_planes[a].back(), len = back - front;
+        if (x < front || x >= back) x -= len * std::floor((x - front) / len);
+        return x < back ? x : std::nextafter(back, front);
+    }
+
+    // Direction byte per particle into m_code, leaver indices (ascending) into m_leave.
+    // Returns whether a particle moved past the neighbour blocks.
+    int classify(const Particles& p) {
+        const std::size_t n = p.size();
+        m_code.resize(n);
+        m_far.resize(n);
+        const unsigned nt = apl_thread_count(n, m_opts.nthreads);
+        std::vector<std::vector<std::size_t>> leave(nt);
+        parallel_for_chunks(n, nt, [&](std::size_t b, std::size_t e, unsigned t) {
+            std::uint8_t* code = m_code.data();
+            std::uint8_t* far = m_far.data();
+            for (std::size_t i = b; i < e; ++i) {
+                code[i] = static_cast<std::uint8_t>(centre);
+                far[i] = 0;
+            }
+            for (unsigned a = 0, w = 1; a < Dim; ++a, w *= 3) {
+                const T* x = p.pos(a);
+                const T lo = static_cast<T>(m_lo[a]), hi = static_cast<T>(m_hi[a]);
+                const T rlo = static_cast<T>(m_reach_lo[a]), rhi = static_cast<T>(m_reach_hi[a]);
+                for (std::size_t i = b; i < e; ++i) {
+                    const T xi = x[i];
+                    code[i] = static_cast<std::uint8_t>(code[i] + w * (xi >= hi) - w * (xi < lo));
+                    far[i] |= static_cast<std::uint8_t>((xi < rlo) | (xi >= rhi));
+                }
+            }
+            for (std::size_t i = b; i < e; ++i) {
+                if (far[i]) code[i] = far_code;
+                if (code[i] != centre) leave[t].push_back(i);
+            }
+        });
+        m_leave.clear();
+        for (auto& l : leave) m_leave.insert(m_leave.end(), l.begin(), l.end());
+        for (std::size_t i : m_leave) {
+            if (m_code[i] == far_code) return 1;
+        }
+        return 0;
+    }
+
+    // Leavers sorted (stably) by destination slot: neighbour index or, all-to-all, rank.
+    void group(const Particles& p, std::size_t nslots, bool all_to_all) {
+        m_slot.resize(m_leave.size());
+        for (std::size_t j = 0; j < m_leave.size(); ++j) {
+            const std::size_t i = m_leave[j];
+            const std::uint8_t q = m_code[i];
+            if (!all_to_all) {
+                m_slot[j] = m_slot_of[q];
+            } else if (q != far_code) {
+                m_slot[j] = m_rank_of[q];
+            } else {
+                std::array<double, Dim> x;
+                for (unsigned a = 0; a < Dim; ++a) x[a] = static_cast<double>(p.pos(a)[i]);
+                m_slot[j] = owner(x);
+            }
+        }
+        m_count.assign(nslots, 0);
+        for (int s : m_slot) ++m_count[static_cast<std::size_t>(s)];
+        m_offset.assign(nslots + 1, 0);
+        for (std::size_t s = 0; s < nslots; ++s) m_offset[s + 1] = m_offset[s] + m_count[s];
+        m_order.resize(m_leave.size());
+        std::vector<std::size_t> next(m_offset.begin(), m_offset.end() - 1);
+        for (std::size_t j = 0; j < m_leave.size(); ++j) m_order[next[static_cast<std::size_t>(m_slot[j])]++] = m_leave[j];
+    }
+
+    template <typename U>
+    static void gather_scalars(const std::byte* from, const std::size_t* idx, std::size_t m, std::byte* to) {
+        const U* src = reinterpret_cast<const U*>(from);
+        U* dst = reinterpret_cast<U*>(to);
+        for (std::size_t j = 0; j < m; ++j) dst[j] = src[idx[j]];
+    }
+
+    // Slot s occupies records [m_offset[s], m_offset[s + 1]) of m_send; inside, component
+    // blocks of m_count[s] scalars follow each other.
+    void pack(const Particles& p, std::size_t record) {
+        m_send.resize(m_leave.size() * record);
+        if (m_leave.empty()) return;
+        const unsigned nt = std::min<unsigned>(apl_thread_count(m_leave.size() * m_comps.size(), m_opts.nthreads),
+                                               static_cast<unsigned>(m_comps.size()));
+        parallel_for_chunks(m_comps.size(), nt, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t j = b; j < e; ++j) {
+                const Component& cp = m_comps[j];
+                const std::byte* from = p.raw(cp.column, cp.k);
+                for (std::size_t s = 0; s < m_count.size(); ++s) {
+                    const std::size_t m = m_count[s];
+                    if (m == 0) continue;
+                    std::byte* to = m_send.data() + m_offset[s] * record + m * cp.offset;
+                    const std::size_t* idx = m_order.data() + m_offset[s];
+                    switch (cp.bytes) {
+                        case 1: gather_scalars<std::uint8_t>(from, idx, m, to); break;
+                        case 2: gather_scalars<std::uint16_t>(from, idx, m, to); break;
+                        case 4: gather_scalars<std::uint32_t>(from, idx, m, to); break;
+                        default: gather_scalars<std::uint64_t>(from, idx, m, to); break;
+                    }
+                }
+            }
+        });
+    }
+
+    void receive_layout(std::size_t record) {
+        m_roffset.assign(m_rcount.size() + 1, 0);
+        for (std::size_t s = 0; s < m_rcount.size(); ++s) m_roffset[s + 1] = m_roffset[s] + m_rcount[s];
+        m_recv.resize(m_roffset.back() * record);
+    }
+
+    void exchange_neighbours(MPI_Datatype rec, std::size_t record) {
+        const std::size_t nn = m_nbrs.size();
+        std::vector<std::uint64_t> scount(m_count.begin(), m_count.end()), rcount(nn, 0);
+        std::vector<MPI_Request> req(2 * nn);
+        // counts: tags 0 .. ndir - 1, data: ndir .. 2 ndir - 1; direction -q as seen from the neighbour
+        for (std::size_t s = 0; s < nn; ++s) {
+            const int q = m_nbrs[s], r = m_rank_of[q];
+            MPI_Irecv(&rcount[s], 1, MPI_UINT64_T, r, ndir - 1 - q, m_comm, &req[s]);
+            MPI_Isend(&scount[s], 1, MPI_UINT64_T, r, q, m_comm, &req[nn + s]);
+        }
+        MPI_Waitall(static_cast<int>(req.size()), req.data(), MPI_STATUSES_IGNORE);
+        m_rcount.assign(rcount.begin(), rcount.end());
+        receive_layout(record);
+        for (std::size_t s = 0; s < nn; ++s) {
+            const int q = m_nbrs[s], r = m_rank_of[q];
+            MPI_Irecv(m_recv.data() + m_roffset[s] * record, static_cast<int>(m_rcount[s]), rec, r, 2 * ndir - 1 - q,
+                      m_comm, &req[s]);
+            MPI_Isend(m_send.data() + m_offset[s] * record, static_cast<int>(m_count[s]), rec, r, ndir + q, m_comm,
+                      &req[nn + s]);
+        }
+        MPI_Waitall(static_cast<int>(req.size()), req.data(), MPI_STATUSES_IGNORE);
+    }
+
+    void exchange_all(MPI_Datatype rec, std::size_t record, int size) {
+        const auto n = static_cast<std::size_t>(size);
+        std::vector<int> scount(n), sdispl(n), rcount(n), rdispl(n);
+        for (std::size_t r = 0; r < n; ++r) {
+            scount[r] = static_cast<int>(m_count[r]);
+            sdispl[r] = static_cast<int>(m_offset[r]);
+        }
+        MPI_Alltoall(scount.data(), 1, MPI_INT, rcount.data(), 1, MPI_INT, m_comm);
+        m_rcount.assign(rcount.begin(), rcount.end());
+        receive_layout(record);
+        for (std::size_t r = 0; r < n; ++r) rdispl[r] = static_cast<int>(m_roffset[r]);
+        MPI_Alltoallv(m_send.data(), scount.data(), sdispl.data(), rec, m_recv.data(), rcount.data(), rdispl.data(),
+                      rec, m_comm);
+    }
+
+    // Drop the leavers (memmove of the runs between them), append the received blocks,
+    // wrap arrived positions across periodic boundaries.
+    void unpack(Particles& p, std::size_t record) {
+        const std::size_t n = p.size(), kept = n - m_leave.size(), arrived = m_roffset.back();
+        if (m_leave.empty() && arrived == 0) return;
+        const unsigned nt = std::min<unsigned>(apl_thread_count((n + arrived) * m_comps.size(), m_opts.nthreads),
+                                               static_cast<unsigned>(m_comps.size()));
+        if (!m_leave.empty()) parallel_for_chunks(m_comps.size(), nt, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t j = b; j < e; ++j) {
+                const Component& cp = m_comps[j];
+                std::byte* base = p.raw(cp.column, cp.k);
+                std::size_t dst = m_leave.front();
+                for (std::size_t l = 0; l < m_leave.size(); ++l) {
+                    const std::size_t from = m_leave[l] + 1, to = l + 1 < m_leave.size() ? m_leave[l + 1] : n;
+                    if (to > from) std::memmove(base + dst * cp.bytes, base + from * cp.bytes, (to - from) * cp.bytes);
+                    dst += to - from;
+                }
+            }
+        });
+        p.resize(kept);
+        p.resize(kept + arrived);   // may reallocate: raw pointers are taken afterwards
+        parallel_for_chunks(m_comps.size(), nt, [&](std::size_t b, std::size_t e, unsigned) {
+            for (std::size_t j = b; j < e; ++j) {
+                const Component& cp = m_comps[j];
+                std::byte* base = p.raw(cp.column, cp.k) + kept * cp.bytes;
+                for (std::size_t s = 0; s < m_rcount.size(); ++s) {
+                    const std::size_t m = m_rcount[s];
+                    if (m == 0) continue;
+                    std::memcpy(base + m_roffset[s] * cp.bytes, m_recv.data() + m_roffset[s] * record + m * cp.offset,
+                                m * cp.bytes);
+                }
+            }
+        });
+        for (unsigned a = 0; a < Dim; ++a) {
+            if (!m_periodic[a]) continue;
+            T* x = p.pos(a) + kept;
+            const T front = static_cast<T>(m_planes[a].front()), back = static_cast<T>(m_planes[a].back());
+            for (std::size_t i = 0; i < arrived; ++i) {
+                if (x[i] < front || x[i] >= back) x[i] = static_cast<T>(wrap(a, static_cast<double>(x[i])));
+            }
+        }
+        p.touch();
+    }
+
+    MPI_Comm m_comm;
+    std::array<std::vector<double>, Dim> m_planes;
+    MigrationOptions m_opts;
+    std::array<int, Dim> m_dims{};
+    std::array<bool, Dim> m_periodic{};
+    std::array<double, Dim> m_lo{}, m_hi{}, m_reach_lo{}, m_reach_hi{};
+    std::array<int, ndir> m_rank_of{};      // neighbour rank per direction (MPI_PROC_NULL: wall/centre)
+    std::array<int, ndir> m_slot_of{};      // index into m_nbrs per direction
+    std::vector<int> m_nbrs;                // directions with a neighbour
+
+    // per-call scratch, kept to avoid reallocations
+    std::vector<std::uint8_t> m_code, m_far;
+    std::vector<std::size_t> m_leave, m_order, m_count, m_offset, m_rcount, m_roffset;
+    std::vector<int> m_slot;
+    std::vector<Component> m_comps;
+    std::vector<std::byte> m_send, m_recv;
+};
+
+#endif  // APL_HAVE_MPI
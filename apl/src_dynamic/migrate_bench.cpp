@@ -0,0 +1,169 @@
+// Particle migration (migrate.h) against the rank count. MPI program.
+//
+// For r = 1, 2, 4, ... up to all ranks, the first r ranks form a periodic 3D process grid
+// (MPI_Dims_create) of unit blocks. Every rank holds `particles` particles, uniformly
+// placed in its block (weak scaling), with a 3 x double velocity, an int64 id and a
+// float tag (= id, to check that columns travel together). Every step moves the particles
+// by their velocity and migrates them. The velocity cases are:
+//   slow   |v| < 0.02 block per axis          (a few % leave, neighbour exchange)
+//   fast   |v| < 0.2 block per axis           (about a quarter leave, neighbour exchange)
+//   jumps  slow, but 0.1 % jump 2.5 blocks    (every step falls back to all-to-all)
+// Each case runs with MigrationMode::Auto and MigrationMode::AllToAll. Times are the
+// slowest rank's mean per step over `steps`, "sent" the share of particles that left per
+// step. "check" verifies that the global count and id sum are unchanged, every particle
+// lies in its rank's block, and every tag still matches its id.
+//
+// Usage: mpiexec -n 8 ./bild/migrate_bench [particles=1000000] [steps=10]
+
+constexpr unsigned Dim = 3;
+using T = double;
+#include "bpl.h"
+
+#ifndef APL_HAVE_MPI
+#error "migrate_bench needs MPI: build with mpicxx -DAPL_HAVE_MPI (make bench_migrate)"
+#endif
+
+#include <iomanip>
+
+using Particles = ParticleSoA<double, 3>;
+
+struct Case {
+    const char* name;
+    double speed;       // max |v| per axis, in blocks per step
+    double jumpers;     // share of particles moving 2.5 blocks per step
+};
+
+static void init(Particles& p, const std::array<double, 3>& lo, std::int64_t first_id, double speed, double jumpers,
+                 std::uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    const std::size_t vel = p.find("velocity"), id = p.find("id"), tag = p.find("tag");
+    for (std::size_t i = 0; i < p.size(); ++i) {
+        const bool jump = u(gen) < jumpers;
+        for (unsigned a = 0; a < 3; ++a) {
+            p.pos(a)[i] = lo[a] + u(gen);
+            p.data<double>(vel, a)[i] = jump ? (a == 0 ? 2.5 : 0.0) : speed * (2.0 * u(gen) - 1.0);
+        }
+        p.data<std::int64_t>(id)[i] = first_id + static_cast<std::int64_t>(i);
+        p.data<float>(tag)[i] = static_cast<float>(first_id + static_cast<std::int64_t>(i));
+    }
+}
+
+static void move(Particles& p) {
+    const std::size_t vel = p.find("velocity");
+    for (unsigned a = 0; a < 3; ++a) {
+        double* x = p.pos(a);
+        const double* v = p.data<double>(vel, a);
+        for (std::size_t i = 0; i < p.size(); ++i) x[i] += v[i];
+    }
+}
+
+// Particles outside the owned block or with a tag that does not match their id.
+static long misplaced(const Particles& p, const ParticleMigration<double, 3>& m) {
+    const std::size_t id = p.find("id"), tag = p.find("tag");
+    long bad = 0;
+    for (std::size_t i = 0; i < p.size(); ++i) {
+        for (unsigned a = 0; a < 3; ++a) bad += p.pos(a)[i] < m.lo(a) || p.pos(a)[i] >= m.hi(a);
+        bad += p.data<float>(tag)[i] != static_cast<float>(p.data<std::int64_t>(id)[i]);
+    }
+    return bad;
+}
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+    const std::size_t n = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    const int steps = argc > 2 ? std::stoi(argv[2]) : 10;
+    int world_rank = 0, world_size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    std::vector<int> counts;
+    for (int r = 1; r < world_size; r *= 2) counts.push_back(r);
+    counts.push_back(world_size);
+
+    if (world_rank == 0) {
+        std::cout << "particles/rank: " << n << ", steps: " << steps << ", columns: position, velocity (3 x f64), "
+                  << "id (i64), tag (f32)\n\n"
+                  << std::right << std::setw(5) << "ranks" << std::setw(8) << "grid" << std::setw(7) << "case"
+                  << std::setw(10) << "mode" << std::setw(10) << "path" << std::setw(8) << "sent" << std::setw(11)
+                  << "ms/step" << std::setw(12) << "Mpart/s" << std::setw(7) << "check" << "\n";
+    }
+    const Case cases[] = {{"slow", 0.02, 0.0}, {"fast", 0.2, 0.0}, {"jumps", 0.02, 0.001}};
+    for (int nr : counts) {
+        MPI_Comm sub;
+        MPI_Comm_split(MPI_COMM_WORLD, world_rank < nr ? 0 : MPI_UNDEFINED, world_rank, &sub);
+        if (sub != MPI_COMM_NULL) {
+            int dims[3] = {0, 0, 0}, coords[3];
+            const int periods[3] = {1, 1, 1};
+            MPI_Dims_create(nr, 3, dims);
+            MPI_Comm cart;
+            MPI_Cart_create(sub, 3, dims, periods, 0, &cart);
+            int rank = 0;
+            MPI_Comm_rank(cart, &rank);
+            MPI_Cart_coords(cart, rank, 3, coords);
+            std::array<std::vector<double>, 3> planes;
+            std::array<double, 3> lo;
+            for (unsigned a = 0; a < 3; ++a) {
+                for (int c = 0; c <= dims[a]; ++c) planes[a].push_back(c);
+                lo[a] = coords[a];
+            }
+
+            for (const Case& cs : cases) {
+                for (MigrationMode mode : {MigrationMode::Auto, MigrationMode::AllToAll}) {
+                    MigrationOptions o;
+                    o.mode = mode;
+                    ParticleMigration<double, 3> mig(cart, planes, o);
+                    Particles p("bench", n);
+                    p.add_attribute<double>("velocity", 3);
+                    p.add_attribute<std::int64_t>("id");
+                    p.add_attribute<float>("tag");
+                    const auto first_id = static_cast<std::int64_t>(rank) * static_cast<std::int64_t>(n);
+                    init(p, lo, first_id, cs.speed, cs.jumpers, 99u + static_cast<std::uint64_t>(rank));
+                    std::int64_t count0 = static_cast<std::int64_t>(p.size()), ids0 = 0;
+                    for (std::size_t i = 0; i < p.size(); ++i) ids0 += p.data<std::int64_t>(p.find("id"))[i];
+
+                    double t = 0.0;
+                    std::uint64_t sent = 0;
+                    int fallback = 0;
+                    for (int s = 0; s < steps; ++s) {
+                        move(p);
+                        MPI_Barrier(cart);
+                        const double t0 = MPI_Wtime();
+                        const MigrationStats st = mig.migrate(p);
+                        t += MPI_Wtime() - t0;
+                        sent += st.sent;
+                        fallback += st.all_to_all;
+                    }
+
+                    std::int64_t count = static_cast<std::int64_t>(p.size()), ids = 0;
+                    for (std::size_t i = 0; i < p.size(); ++i) ids += p.data<std::int64_t>(p.find("id"))[i];
+                    std::int64_t sums[4] = {count0, ids0, count, ids};
+                    long bad = misplaced(p, mig);
+                    MPI_Allreduce(MPI_IN_PLACE, sums, 4, MPI_INT64_T, MPI_SUM, cart);
+                    MPI_Allreduce(MPI_IN_PLACE, &bad, 1, MPI_LONG, MPI_SUM, cart);
+                    MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, cart);
+                    MPI_Allreduce(MPI_IN_PLACE, &sent, 1, MPI_UINT64_T, MPI_SUM, cart);
+                    const bool ok = bad == 0 && sums[0] == sums[2] && sums[1] == sums[3];
+                    if (rank == 0) {
+                        const double total = static_cast<double>(n) * nr;
+                        const std::string grid =
+                            std::to_string(dims[0]) + "x" + std::to_string(dims[1]) + "x" + std::to_string(dims[2]);
+                        const char* path = fallback == 0 ? "nbrs" : fallback == steps ? "a2a" : "mixed";
+                        std::cout << std::setw(5) << nr << std::setw(8) << grid << std::setw(7) << cs.name
+                                  << std::setw(10) << migration_mode_name(mode) << std::setw(10) << path << std::fixed
+                                  << std::setprecision(1) << std::setw(7)
+                                  << 100.0 * static_cast<double>(sent) / (total * steps) << "%" << std::setw(11)
+                                  << std::setprecision(2) << 1e3 * t / steps << std::setw(12) << std::setprecision(1)
+                                  << total * steps / t * 1e-6 << std::setw(7) << (ok ? "ok" : "FAIL") << "\n";
+                    }
+                }
+            }
+            MPI_Comm_free(&cart);
+            MPI_Comm_free(&sub);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "Vis_forward.h"
+
+#include <algorithm>
+#include <thread>
+
+// Minimal fork/join helpers shared by the data-parallel kernels (reductions, ...).
+// No thread pool: a call splits [0, n) into contiguous chunks, runs one std::thread
+// per chunk and joins. Small ranges run inline on the calling thread.
+
+// Below this many items per thread the spawn cost dominates; run inline instead.
+inline constexpr std::size_t apl_min_items_per_thread = 1u << 14;
+
+// Pick a thread count for n items. requested == 0 means "use the hardware".
+inline unsigned apl_thread_count(std::size_t n, unsigned requested = 0) {
+    unsigned hw = requested ? requested : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t by_size = std::max<std::size_t>(1, n / apl_min_items_per_thread);
+    return static_cast<unsigned>(std::min<std::size_t>(hw, by_size));
+}
+
+// Calls fn(begin, end, tid) for nthreads contiguous chunks of [0, n).
+// Chunk tid is always the tid-th slice, so per-thread partials can be merged in order.
+template <typename Fn>
+void parallel_for_chunks(std::size_t n, unsigned nthreads, Fn&& fn) {
+    if (nthreads <= 1 || n == 0) {
+        fn(std::size_t{0}, n, 0u);
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(nthreads - 1);
+    const std::size_t chunk = (n + nthreads - 1) / nthreads;
+    for (unsigned t = 1; t < nthreads; ++t) {
+        const std::size_t b = std::min(n, t * chunk);
+        const std::size_t e = std::min(n, b + chunk);
+        workers.emplace_back([&fn, b, e, t] { fn(b, e, t); });
+    }
+    fn(std::size_t{0}, std::min(n, chunk), 0u);
+    for (auto& w : workers) w.join();
+}
@@ -1,11 +1,22 @@
 #pragma once
 #include "bpl.h"
+#include "descriptor.h"
 
 
 
 class ParticleBase_b{
     public:
     std::string bunch_ID;
+    std::uint64_t version = 0;  // bumped by touch() whenever the particles change
+    virtual ~ParticleBase_b() = default;
+
+    void touch() noexcept { ++version; }
+
+    // Zero-copy description of the particle storage (see descriptor.h).
+    virtual DataDescriptor describe() const = 0;
+
+    protected:
+    LifetimeToken lifetime;
  
 };
 
@@ -21,6 +32,12 @@ class ParticleBase : public ParticleBase_b {
     ParticleBase(std::string name);
     ParticleBase(std::string name, T v);
 
+    // One vec<T,Dim> per container: a single element with Dim components.
+    DataDescriptor describe() const override {
+        DataDescriptor d = describe_contiguous(&data, 1);
+        d.owner = lifetime.weak();
+        return d;
+    }
 
 };
 
@@ -0,0 +1,235 @@
+#pragma once
+#include "Vis_forward.h"
+#include "descriptor.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// Needs ParticleBase_b complete: include via bpl.h.
+
+// Structure-of-arrays particle container with a runtime particle count.
+// - Column 0 is the position: Dim components of T. Further columns (attributes) are added
+//   with add_attribute<S>(name, components), e.g. velocity (3 x double), charge, id.
+// - A column with N components stores them as N consecutive blocks of capacity() scalars
+//   ([x0 x1 ... | y0 y1 ... | ...]), so every component is a dense array (SIMD friendly)
+//   and describe() can still express the column as one DataDescriptor: element stride
+//   sizeof(S), component_stride capacity() * sizeof(S).
+// - resize()/reserve() keep the contents; growing the capacity reallocates every column
+//   (pointers and descriptors taken before are invalidated).
+// - copy_particle() / compact() move whole particles across all columns, which is what
+//   decimation and migration build on.
+
+template <typename T, unsigned Dim>
+class ParticleSoA : public ParticleBase_b {
+public:
+    using value_type = T;
+    static constexpr unsigned dim = Dim;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    struct Column {
+        std::string name;
+        DType dtype = DType::Float64;
+        unsigned components = 1;
+        std::size_t scalar_bytes = 0;
+        std::vector<std::byte> bytes;   // components x capacity scalars
+    };
+
+    ParticleSoA() : ParticleSoA("ParticleSoA_unlabeled") {}
+
+    explicit ParticleSoA(std::string name, std::size_t n = 0) {
+        bunch_ID = std::move(name);
+        add_column<T>("position", Dim);
+        resize(n);
+    }
+
+    std::size_t size() const noexcept { return m_size; }
+    std::size_t capacity() const noexcept { return m_capacity; }
+
+    // Attribute column of `components` x S; returns its index. Values start zeroed.
+    template <typename S>
+    std::size_t add_attribute(const std::string& name, unsigned components = 1) {
+        if (find(name) != npos) throw std::invalid_argument("ParticleSoA: column '" + name + "' exists");
+        return add_column<S>(name, components);
+    }
+
+    // Column index of `name`, or npos.
+    std::size_t find(const std::string& name) const {
+        for (std::size_t c = 0; c < m_columns.size(); ++c) {
+            if (m_columns[c].name == name) return c;
+        }
+        return npos;
+    }
+
+    std::size_t num_columns() const noexcept { return m_columns.size(); }
+    const Column& column(std::size_t c) const { return m_columns.at(c); }
+
+    void reserve(std::size_t n) {
+        if (n <= m_capacity) return;
+        const std::size_t cap = std::max(n, m_capacity + m_capacity / 2);
+        for (auto& col : m_columns) {
+            std::vector<std::byte> grown(cap * col.components * col.scalar_bytes);
+            for (unsigned k = 0; k < col.components; ++k) {
+                std::memcpy(grown.data() + k * cap * col.scalar_bytes,
+                            col.bytes.data() + k * m_capacity * col.scalar_bytes, m_size * col.scalar_bytes);
+            }
+            col.bytes = std::move(grown);
+        }
+        m_capacity = cap;
+    }
+
+    void resize(std::size_t n) {
+        reserve(n);
+        m_size = n;
+    }
+
+    void clear() noexcept { m_size = 0; }
+
+    // Typed component array of a column (dtype checked).
+    template <typename S>
+    S* data(std::size_t c, unsigned component = 0) {
+        return const_cast<S*>(std::as_const(*this).template data<S>(c, component));
+    }
+
+    template <typename S>
+    const S* data(std::size_t c, unsigned component = 0) const {
+        const Column& col = m_columns.at(c);
+        if (dtype_of<S>() != col.dtype) {
+            throw std::invalid_argument("ParticleSoA: column '" + col.name + "' is " + dtype_name(col.dtype) +
+                                        ", requested " + dtype_name(dtype_of<S>()));
+        }
+        if (component >= col.components) throw std::out_of_range("ParticleSoA: component out of range");
+        return reinterpret_cast<const S*>(col.bytes.data()) + component * m_capacity;
+    }
+
+    // Untyped component array of a column (column(c).scalar_bytes per particle), for packing.
+    std::byte* raw(std::size_t c, unsigned component = 0) {
+        return const_cast<std::byte*>(std::as_const(*this).raw(c, component));
+    }
+
+    const std::byte* raw(std::size_t c, unsigned component = 0) const {
+        const Column& col = m_columns.at(c);
+        if (component >= col.components) throw std::out_of_range("ParticleSoA: component out of range");
+        return col.bytes.data() + component * m_capacity * col.scalar_bytes;
+    }
+
+    T* pos(unsigned d) { return data<T>(0, d); }
+    const T* pos(unsigned d) const { return data<T>(0, d); }
+
+    // Copy particle `src` of `from` (same column layout) to slot `dst` of this container.
+    void copy_particle(const ParticleSoA& from, std::size_t src, std::size_t dst) {
+        for (std::size_t c = 0; c < m_columns.size(); ++c) {
+            Column& to = m_columns[c];
+            const Column& fr = from.m_columns[c];
+            for (unsigned k = 0; k < to.components; ++k) {
+                std::memcpy(to.bytes.data() + (k * m_capacity + dst) * to.scalar_bytes,
+                            fr.bytes.data() + (k * from.m_capacity + src) * fr.scalar_bytes, to.scalar_bytes);
+            }
+        }
+    }
+
+    // Keep the particles for which keep(i) is true, in order; returns the new size.
+    template <typename Keep>
+    std::size_t compact(Keep&& keep) {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < m_size; ++i) {
+            if (!keep(i)) continue;
+            if (n != i) copy_particle(*this, i, n);
+            ++n;
+        }
+        m_size = n;
+        return n;
+    }
+
+    // Reorder all columns: particle i becomes the former particle order[i] (a permutation
+    // of 0 .. size() - 1, e.g. TileBins::order). Components run in parallel.
+    void permute(const std::vector<std::size_t>& order, unsigned nthreads = 0) {
+        if (order.size() != m_size) throw std::invalid_argument("ParticleSoA: permutation of the wrong size");
+        std::vector<std::pair<std::size_t, unsigned>> comps;
+        for (std::size_t c = 0; c < m_columns.size(); ++c) {
+            for (unsigned k = 0; k < m_columns[c].components; ++k) comps.emplace_back(c, k);
+        }
+        const unsigned nt = std::min<unsigned>(apl_thread_count(m_size * comps.size(), nthreads),
+                                               static_cast<unsigned>(comps.size()));
+        parallel_for_chunks(comps.size(), nt, [&](std::size_t b, std::size_t e, unsigned) {
+            std::vector<std::byte> tmp;
+            for (std::size_t j = b; j < e; ++j) {
+                const auto [c, k] = comps[j];
+                switch (m_columns[c].scalar_bytes) {
+                    case 1: permute_component<std::uint8_t>(raw(c, k), order, tmp); break;
+                    case 2: permute_component<std::uint16_t>(raw(c, k), order, tmp); break;
+                    case 4: permute_component<std::uint32_t>(raw(c, k), order, tmp); break;
+                    default: permute_component<std::uint64_t>(raw(c, k), order, tmp); break;
+                }
+            }
+        });
+    }
+
+    // Same column layout (names, dtypes, components), e.g. for packing / decimated copies.
+    bool same_layout(const ParticleSoA& o) const {
+        if (o.m_columns.size() != m_columns.size()) return false;
+        for (std::size_t c = 0; c < m_columns.size(); ++c) {
+            const Column &a = m_columns[c], &b = o.m_columns[c];
+            if (a.name != b.name || a.dtype != b.dtype || a.components != b.components) return false;
+        }
+        return true;
+    }
+
+    // Empty container with the same columns.
+    ParticleSoA empty_like(std::string name) const {
+        ParticleSoA p(std::move(name));
+        for (std::size_t c = 1; c < m_columns.size(); ++c) {
+            const Column& col = m_columns[c];
+            p.m_columns.push_back(Column{col.name, col.dtype, col.components, col.scalar_bytes, {}});
+        }
+        return p;
+    }
+
+    // Positions (column 0).
+    DataDescriptor describe() const override { return describe_column(0); }
+
+    DataDescriptor describe_column(std::size_t c) const {
+        const Column& col = m_columns.at(c);
+        DataDescriptor d;
+        d.data = const_cast<std::byte*>(col.bytes.data());
+        d.dtype = col.dtype;
+        d.components = col.components;
+        d.ndim = 1;
+        d.extents[0] = static_cast<std::int64_t>(m_size);
+        d.strides[0] = static_cast<std::int64_t>(col.scalar_bytes);
+        d.component_stride = static_cast<std::int64_t>(m_capacity * col.scalar_bytes);
+        d.owner = lifetime.weak();
+        return d;
+    }
+
+    // Bytes of the used part of all columns.
+    std::size_t bytes() const noexcept {
+        std::size_t b = 0;
+        for (const auto& col : m_columns) b += m_size * col.components * col.scalar_bytes;
+        return b;
+    }
+
+private:
+    template <typename W>
+    void permute_component(std::byte* base, const std::vector<std::size_t>& order, std::vector<std::byte>& tmp) const {
+        tmp.resize(m_size * sizeof(W));
+        W* src = reinterpret_cast<W*>(base);
+        W* dst = reinterpret_cast<W*>(tmp.data());
+        for (std::size_t i = 0; i < m_size; ++i) dst[i] = src[order[i]];
+        std::memcpy(base, tmp.data(), tmp.size());
+    }
+
+    template <typename S>
+    std::size_t add_column(const std::string& name, unsigned components) {
+        if (components == 0) throw std::invalid_argument("ParticleSoA: column '" + name + "' needs components");
+        Column col{name, dtype_of<S>(), components, sizeof(S), {}};
+        col.bytes.resize(m_capacity * components * sizeof(S));
+        m_columns.push_back(std::move(col));
+        return m_columns.size() - 1;
+    }
+
+    std::vector<Column> m_columns;
+    std::size_t m_size = 0;
+    std::size_t m_capacity = 0;
+};
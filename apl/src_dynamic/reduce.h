@@ -0,0 +1,252 @@
+#pragma once
+#include "Vis_forward.h"
+#include "parallel.h"
+
+#include <cmath>
+#include <limits>
+
+#ifdef APL_HAVE_MPI
+#include <mpi.h>
+#endif
+
+// Field reductions for visualization: min/max/mean/L2 in one pass over the storage.
+// - Scalars: one FieldStats per field.
+// - vec<S,N>: one FieldStats per component plus one for the magnitude |v|.
+// - Work is split into contiguous chunks (one per thread); each thread reduces its chunk
+//   into a private partial which is merged afterwards (no shared writes in the hot loop).
+// - The inner loop keeps `apl_reduce_lanes` independent accumulators so the compiler can
+//   map them onto SIMD registers (-O2/-O3 auto-vectorization, no intrinsics).
+
+inline constexpr std::size_t apl_reduce_lanes = 8;
+
+template <typename S>
+struct FieldStats {
+    S min = std::numeric_limits<S>::max();
+    S max = std::numeric_limits<S>::lowest();
+    double sum = 0.0;    // sum of values
+    double sumsq = 0.0;  // sum of squared values
+    std::size_t count = 0;
+
+    double mean() const noexcept { return count ? sum / static_cast<double>(count) : 0.0; }
+    double l2() const noexcept { return std::sqrt(sumsq); }
+
+    void merge(const FieldStats& o) noexcept {
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+        sum += o.sum;
+        sumsq += o.sumsq;
+        count += o.count;
+    }
+};
+
+// Magnitudes of integer vectors are not integers; keep them in double.
+template <typename S>
+using magnitude_t = std::conditional_t<std::is_floating_point_v<S>, S, double>;
+
+template <typename S, unsigned N>
+struct VecFieldStats {
+    std::array<FieldStats<S>, N> components{};
+    FieldStats<magnitude_t<S>> magnitude{};
+
+    void merge(const VecFieldStats& o) noexcept {
+        for (unsigned c = 0; c < N; ++c) components[c].merge(o.components[c]);
+        magnitude.merge(o.magnitude);
+    }
+};
+
+template <typename S>
+std::ostream& operator<<(std::ostream& os, const FieldStats<S>& s) {
+    os << "{min=" << s.min << ", max=" << s.max << ", mean=" << s.mean()
+       << ", l2=" << s.l2() << ", n=" << s.count << "}";
+    return os;
+}
+
+template <typename S, unsigned N>
+std::ostream& operator<<(std::ostream& os, const VecFieldStats<S, N>& s) {
+    for (unsigned c = 0; c < N; ++c) os << "c" << c << "=" << s.components[c] << " ";
+    os << "|v|=" << s.magnitude;
+    return os;
+}
+
+
+
+// --- Single-thread kernels (one chunk) ---
+
+template <typename S>
+FieldStats<S> reduce_chunk(const S* p, std::size_t n) {
+    constexpr std::size_t L = apl_reduce_lanes;
+    S mn[L], mx[L];
+    double s[L], q[L];
+    for (std::size_t l = 0; l < L; ++l) {
+        mn[l] = std::numeric_limits<S>::max();
+        mx[l] = std::numeric_limits<S>::lowest();
+        s[l] = 0.0;
+        q[l] = 0.0;
+    }
+
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+        for (std::size_t l = 0; l < L; ++l) {
+            const S v = p[i + l];
+            const double d = static_cast<double>(v);
+            mn[l] = v < mn[l] ? v : mn[l];
+            mx[l] = v > mx[l] ? v : mx[l];
+            s[l] += d;
+            q[l] += d * d;
+        }
+    }
+    for (std::size_t l = 0; i < n; ++i, ++l) {
+        const S v = p[i];
+        const double d = static_cast<double>(v);
+        mn[l] = v < mn[l] ? v : mn[l];
+        mx[l] = v > mx[l] ? v : mx[l];
+        s[l] += d;
+        q[l] += d * d;
+    }
+
+    FieldStats<S> out;
+    for (std::size_t l = 0; l < L; ++l) {
+        out.min = std::min(out.min, mn[l]);
+        out.max = std::max(out.max, mx[l]);
+        out.sum += s[l];
+        out.sumsq += q[l];
+    }
+    out.count = n;
+    return out;
+}
+
+// AoS vec<S,N>: components and magnitude in the same sweep over memory.
+template <typename S, unsigned N>
+VecFieldStats<S, N> reduce_chunk(const vec<S, N>* p, std::size_t n) {
+    using M = magnitude_t<S>;
+    S mn[N], mx[N];
+    double s[N], q[N];
+    for (unsigned c = 0; c < N; ++c) {
+        mn[c] = std::numeric_limits<S>::max();
+        mx[c] = std::numeric_limits<S>::lowest();
+        s[c] = 0.0;
+        q[c] = 0.0;
+    }
+    M mmn = std::numeric_limits<M>::max();
+    M mmx = std::numeric_limits<M>::lowest();
+    double ms = 0.0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        double r2 = 0.0;
+        for (unsigned c = 0; c < N; ++c) {
+            const S v = p[i][c];
+            const double d = static_cast<double>(v);
+            mn[c] = v < mn[c] ? v : mn[c];
+            mx[c] = v > mx[c] ? v : mx[c];
+            s[c] += d;
+            q[c] += d * d;
+            r2 += d * d;
+        }
+        const M m = static_cast<M>(std::sqrt(r2));
+        mmn = m < mmn ? m : mmn;
+        mmx = m > mmx ? m : mmx;
+        ms += static_cast<double>(m);
+    }
+
+    VecFieldStats<S, N> out;
+    double msq = 0.0;
+    for (unsigned c = 0; c < N; ++c) {
+        out.components[c].min = mn[c];
+        out.components[c].max = mx[c];
+        out.components[c].sum = s[c];
+        out.components[c].sumsq = q[c];
+        out.components[c].count = n;
+        msq += q[c];  // sum |v|^2 == sum over components of sum v_c^2
+    }
+    out.magnitude.min = mmn;
+    out.magnitude.max = mmx;
+    out.magnitude.sum = ms;
+    out.magnitude.sumsq = msq;
+    out.magnitude.count = n;
+    return out;
+}
+
+
+
+// --- Multithreaded drivers ---
+
+// nthreads == 0: pick from hardware and problem size (see apl_thread_count).
+template <typename T>
+auto reduce_stats(const T* p, std::size_t n, unsigned nthreads = 0) {
+    using Stats = decltype(reduce_chunk(p, n));
+    const unsigned nt = apl_thread_count(n, nthreads);
+    std::vector<Stats> partial(nt);
+    parallel_for_chunks(n, nt, [&](std::size_t b, std::size_t e, unsigned t) {
+        partial[t] = reduce_chunk(p + b, e - b);
+    });
+    Stats out = partial[0];
+    for (unsigned t = 1; t < nt; ++t) out.merge(partial[t]);
+    return out;
+}
+
+// Statistics over the storage of a Field (scalar or vec element types).
+template <typename T, unsigned Dim>
+auto reduce_field(const Field<T, Dim>& f, unsigned nthreads = 0) {
+    return reduce_stats(f.data.data(), f.data.size(), nthreads);
+}
+
+
+
+#ifdef APL_HAVE_MPI
+// Global statistics across `comm`. Min/max travel as double, which is exact for
+// float/double and all integer types up to 32 bits.
+// Three collectives per call (MIN, MAX, SUM) regardless of the number of components.
+template <typename S>
+void allreduce_stats(FieldStats<S>& st, MPI_Comm comm) {
+    double lo = static_cast<double>(st.min);
+    double hi = static_cast<double>(st.max);
+    double sums[3] = {st.sum, st.sumsq, static_cast<double>(st.count)};
+    MPI_Allreduce(MPI_IN_PLACE, &lo, 1, MPI_DOUBLE, MPI_MIN, comm);
+    MPI_Allreduce(MPI_IN_PLACE, &hi, 1, MPI_DOUBLE, MPI_MAX, comm);
+    MPI_Allreduce(MPI_IN_PLACE, sums, 3, MPI_DOUBLE, MPI_SUM, comm);
+    st.min = static_cast<S>(lo);
+    st.max = static_cast<S>(hi);
+    st.sum = sums[0];
+    st.sumsq = sums[1];
+    st.count = static_cast<std::size_t>(sums[2]);
+}
+
+template <typename S, unsigned N>
+void allreduce_stats(VecFieldStats<S, N>& st, MPI_Comm comm) {
+    constexpr unsigned K = N + 1;  // components + magnitude
+    double lo[K], hi[K], sums[3 * K];
+    for (unsigned c = 0; c < K; ++c) {
+        const bool mag = (c == N);
+        lo[c] = mag ? static_cast<double>(st.magnitude.min) : static_cast<double>(st.components[c].min);
+        hi[c] = mag ? static_cast<double>(st.magnitude.max) : static_cast<double>(st.components[c].max);
+        sums[3 * c + 0] = mag ? st.magnitude.sum : st.components[c].sum;
+        sums[3 * c + 1] = mag ? st.magnitude.sumsq : st.components[c].sumsq;
+        sums[3 * c + 2] = static_cast<double>(mag ? st.magnitude.count : st.components[c].count);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, lo, K, MPI_DOUBLE, MPI_MIN, comm);
+    MPI_Allreduce(MPI_IN_PLACE, hi, K, MPI_DOUBLE, MPI_MAX, comm);
+    MPI_Allreduce(MPI_IN_PLACE, sums, 3 * K, MPI_DOUBLE, MPI_SUM, comm);
+    for (unsigned c = 0; c < N; ++c) {
+        auto& s = st.components[c];
+        s.min = static_cast<S>(lo[c]);
+        s.max = static_cast<S>(hi[c]);
+        s.sum = sums[3 * c + 0];
+        s.sumsq = sums[3 * c + 1];
+        s.count = static_cast<std::size_t>(sums[3 * c + 2]);
+    }
+    using M = magnitude_t<S>;
+    st.magnitude.min = static_cast<M>(lo[N]);
+    st.magnitude.max = static_cast<M>(hi[N]);
+    st.magnitude.sum = sums[3 * N + 0];
+    st.magnitude.sumsq = sums[3 * N + 1];
+    st.magnitude.count = static_cast<std::size_t>(sums[3 * N + 2]);
+}
+
+// Convenience: local reduction followed by the global one.
+template <typename T, unsigned Dim>
+auto reduce_field_global(const Field<T, Dim>& f, MPI_Comm comm, unsigned nthreads = 0) {
+    auto st = reduce_field(f, nthreads);
+    allreduce_stats(st, comm);
+    return st;
+}
+#endif
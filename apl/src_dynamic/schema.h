@@ -0,0 +1,108 @@
+#pragma once
+#include "Vis_forward.h"
+#include "descriptor.h"
+
+// Needs Field<T,Dim> and ParticleBase<T,Dim> complete: include via bpl.h.
+
+// Compile-time Blueprint schema of APL containers.
+// Everything the Conduit side needs about a Field<T,Dim> / ParticleBase<T,Dim> follows
+// from its type: scalar type (scalar_type_t), components (vector_dimension_v), element
+// count, strides and the mcarray component names. ContainerSchema<C> exposes these as
+// constants, and schema_value_path<Id, C, c> builds "fields/<Id>/values[/x]" as a
+// constexpr NUL-terminated string, so publishing needs no runtime string building.
+//
+// Layout (same as describe()):
+// - Field<T,Dim>: Dim elements of T; T = vec<S,N> gives N interleaved components of S.
+// - ParticleBase<T,Dim>: one element vec<T,Dim> (Dim components of T).
+// Component names: none for scalars, x/y/z/w up to 4 components, c0, c1, ... beyond.
+
+// Writes the mcarray name of component c of n (if out != nullptr); returns its length.
+constexpr std::size_t schema_component_name(unsigned c, unsigned n, char* out = nullptr) {
+    if (n <= 1) return 0;
+    if (n <= 4) {
+        if (out) out[0] = "xyzw"[c];
+        return 1;
+    }
+    char digits[10]{};
+    std::size_t nd = 0;
+    do { digits[nd++] = static_cast<char>('0' + c % 10); c /= 10; } while (c);
+    if (out) {
+        out[0] = 'c';
+        for (std::size_t i = 0; i < nd; ++i) out[1 + i] = digits[nd - 1 - i];
+    }
+    return 1 + nd;
+}
+
+// Fixed-size, NUL-terminated compile-time string.
+template <std::size_t N>
+struct schema_string {
+    char data[N + 1]{};
+    constexpr std::string_view sv() const { return {data, N}; }
+    constexpr const char* c_str() const { return data; }
+};
+
+template <typename Elem, std::int64_t Count, bool Particles>
+struct ContainerLayout {
+    using element_type = Elem;
+    using scalar_type = scalar_type_t<Elem>;
+    static constexpr unsigned components = vector_dimension_v<Elem>;
+    static constexpr std::int64_t count = Count;
+    static constexpr DType dtype = dtype_of<scalar_type>();
+    static constexpr std::int64_t element_stride = sizeof(Elem);
+    static constexpr std::int64_t component_stride = sizeof(scalar_type);
+    static constexpr bool particles = Particles;
+
+    static_assert(sizeof(Elem) == sizeof(scalar_type) * components,
+                  "ContainerSchema: element type is not densely packed");
+};
+
+template <typename C>
+struct ContainerSchema {
+    static_assert(!std::is_same_v<C, C>, "ContainerSchema: not a Field<T,Dim> or ParticleBase<T,Dim>");
+};
+
+template <typename T, unsigned Dim>
+struct ContainerSchema<Field<T, Dim>> : ContainerLayout<T, Dim, false> {};
+
+template <typename T, unsigned Dim>
+struct ContainerSchema<ParticleBase<T, Dim>> : ContainerLayout<vec<T, Dim>, 1, true> {};
+
+// "fields/<Id>/values" or "fields/<Id>/values/<component C>".
+template <fixed_string Id, typename Container, unsigned C>
+struct schema_value_path {
+    static constexpr unsigned n = ContainerSchema<Container>::components;
+    static_assert(C < n || (C == 0 && n == 1), "schema_value_path: component out of range");
+
+    static constexpr std::string_view prefix = "fields/";
+    static constexpr std::string_view values = "/values";
+    static constexpr std::size_t comp = schema_component_name(C, n);
+    static constexpr std::size_t size = prefix.size() + Id.sv().size() + values.size() + (comp ? 1 + comp : 0);
+
+    static constexpr schema_string<size> value = [] {
+        schema_string<size> s;
+        std::size_t i = 0;
+        for (char ch : prefix) s.data[i++] = ch;
+        for (char ch : Id.sv()) s.data[i++] = ch;
+        for (char ch : values) s.data[i++] = ch;
+        if (comp) {
+            s.data[i++] = '/';
+            schema_component_name(C, n, s.data + i);
+        }
+        return s;
+    }();
+};
+
+// "fields/<Id>" (association / topology live below it).
+template <fixed_string Id>
+struct schema_field_path {
+    static constexpr std::string_view prefix = "fields/";
+    static constexpr std::size_t size = prefix.size() + Id.sv().size();
+
+    static constexpr schema_string<size> value = [] {
+        schema_string<size> s;
+        std::size_t i = 0;
+        for (char ch : prefix) s.data[i++] = ch;
+        for (char ch : Id.sv()) s.data[i++] = ch;
+        return s;
+    }();
+};
@@ -0,0 +1,191 @@
+#pragma once
+#include "Vis_forward.h"
+#include "parallel.h"
+
+#include <cmath>
+
+// Needs GridField complete: include via bpl.h.
+
+// Particle <-> grid mapping shared by deposit.h and gather.h.
+// - GridMap: physical placement of a GridField's owned cells (lower corner of owned cell 0
+//   and the spacing); values are cell centred, so a particle at x has the fractional cell
+//   coordinate xi = (x - origin) / h - 0.5.
+// - Shape functions (per axis, weights sum to 1):
+//     NGP  nearest cell                              support 1
+//     CIC  linear between the two nearest centres   support 2
+//     TSC  quadratic spline over three cells        support 3
+//   A particle inside the owned cells reaches at most one cell past them (ghost width 1).
+// - TileBins: counting sort of the particles by tile (tile^Dim owned cells). Keeps the
+//   nearest cell of every particle (linear GridField index) for reuse by the kernels,
+//   and the particle order grouped by tile for cache-friendly / colored processing.
+
+enum class Shape { NGP, CIC, TSC };
+
+constexpr const char* shape_name(Shape s) {
+    switch (s) {
+        case Shape::NGP: return "NGP";
+        case Shape::CIC: return "CIC";
+        case Shape::TSC: return "TSC";
+    }
+    return "unknown";
+}
+
+// Ghost layers a shape needs around the owned cells.
+constexpr std::size_t shape_reach(Shape s) { return s == Shape::NGP ? 0 : 1; }
+
+template <Shape S>
+struct ShapeWeights;
+
+template <>
+struct ShapeWeights<Shape::NGP> {
+    static constexpr int support = 1;
+    template <typename R>
+    static void eval(R xi, std::ptrdiff_t& i0, R* w) {
+        i0 = static_cast<std::ptrdiff_t>(std::floor(xi + R(0.5)));
+        w[0] = R(1);
+    }
+};
+
+template <>
+struct ShapeWeights<Shape::CIC> {
+    static constexpr int support = 2;
+    template <typename R>
+    static void eval(R xi, std::ptrdiff_t& i0, R* w) {
+        const R f = std::floor(xi);
+        const R d = xi - f;
+        i0 = static_cast<std::ptrdiff_t>(f);
+        w[0] = R(1) - d;
+        w[1] = d;
+    }
+};
+
+template <>
+struct ShapeWeights<Shape::TSC> {
+    static constexpr int support = 3;
+    template <typename R>
+    static void eval(R xi, std::ptrdiff_t& i0, R* w) {
+        const R c = std::floor(xi + R(0.5));
+        const R d = xi - c;  // [-0.5, 0.5)
+        i0 = static_cast<std::ptrdiff_t>(c) - 1;
+        w[0] = R(0.5) * (R(0.5) - d) * (R(0.5) - d);
+        w[1] = R(0.75) - d * d;
+        w[2] = R(0.5) * (R(0.5) + d) * (R(0.5) + d);
+    }
+};
+
+template <unsigned Dim>
+struct GridMap {
+    std::array<double, Dim> origin{};   // lower corner of owned cell 0
+    std::array<double, Dim> spacing{};
+
+    GridMap() { spacing.fill(1.0); }
+    GridMap(std::array<double, Dim> o, std::array<double, Dim> h) : origin(o), spacing(h) {}
+
+    // Fractional cell coordinate along axis a (owned cell c has its centre at c).
+    double cell_coord(unsigned a, double x) const { return (x - origin[a]) / spacing[a] - 0.5; }
+
+    double cell_volume() const {
+        double v = 1.0;
+        for (double h : spacing) v *= h;
+        return v;
+    }
+};
+
+// Particles binned by tile of the owned cells of a GridField layout.
+template <unsigned Dim>
+struct TileBins {
+    std::size_t tile = 8;                      // owned cells per tile and axis
+    std::array<std::size_t, Dim> tiles{};      // tiles per axis
+    std::vector<std::size_t> cell;             // nearest cell per particle (GridField::index), particle order
+    std::vector<std::size_t> begin;            // particles of tile t: order[begin[t] .. begin[t + 1])
+    std::vector<std::size_t> order;            // particle indices grouped by tile
+
+    std::size_t num_tiles() const noexcept { return begin.empty() ? 0 : begin.size() - 1; }
+    std::size_t num_particles() const noexcept { return order.size(); }
+
+    // Tile coordinates of linear tile index t (axis 0 fastest).
+    std::array<std::size_t, Dim> tile_coords(std::size_t t) const {
+        std::array<std::size_t, Dim> c{};
+        for (unsigned a = 0; a < Dim; ++a) {
+            c[a] = t % tiles[a];
+            t /= tiles[a];
+        }
+        return c;
+    }
+};
+
+// Bin the particles of `p` (positions inside the owned cells of `f`) by tile of `tile`
+// cells. Counting sort with per-thread histograms; `order` is stable within a tile.
+template <typename Particles, typename T, unsigned Dim>
+TileBins<Dim> bin_particles(const Particles& p, const GridField<T, Dim>& f, const GridMap<Dim>& map,
+                            std::size_t tile = 8, unsigned nthreads = 0) {
+    static_assert(Particles::dim == Dim, "bin_particles: particle and grid dimensions differ");
+    if (tile == 0) throw std::invalid_argument("bin_particles: tile must be > 0");
+
+    TileBins<Dim> b;
+    b.tile = tile;
+    std::size_t ntiles = 1;
+    for (unsigned a = 0; a < Dim; ++a) {
+        b.tiles[a] = (f.extents[a] + tile - 1) / tile;
+        ntiles *= b.tiles[a];
+    }
+    const std::size_t n = p.size();
+    b.cell.resize(n);
+    b.order.resize(n);
+    b.begin.assign(ntiles + 1, 0);
+
+    const unsigned nt = apl_thread_count(n, nthreads);
+    std::vector<std::vector<std::size_t>> count(nt, std::vector<std::size_t>(ntiles, 0));
+    std::vector<std::uint32_t> tile_of(n);
+
+    parallel_for_chunks(n, nt, [&](std::size_t lo, std::size_t hi, unsigned t) {
+        std::array<const typename Particles::value_type*, Dim> x;
+        for (unsigned a = 0; a < Dim; ++a) x[a] = p.pos(a);
+        std::vector<std::size_t>& c = count[t];
+        for (std::size_t i = lo; i < hi; ++i) {
+            std::size_t l = 0, s = 1, tl = 0, ts = 1;
+            for (unsigned a = 0; a < Dim; ++a) {
+                const auto ci = static_cast<std::ptrdiff_t>(std::floor(map.cell_coord(a, x[a][i]) + 0.5));
+                const auto cc = static_cast<std::size_t>(
+                    std::clamp<std::ptrdiff_t>(ci, 0, static_cast<std::ptrdiff_t>(f.extents[a]) - 1));
+                l += (cc + f.ghost) * s;
+                s *= f.allocated(a);
+                tl += (cc / tile) * ts;
+                ts *= b.tiles[a];
+            }
+            b.cell[i] = l;
+            tile_of[i] = static_cast<std::uint32_t>(tl);
+            ++c[tl];
+        }
+    });
+
+    // prefix over (tile, thread): thread t's particles of tile k follow thread t-1's
+    std::size_t run = 0;
+    for (std::size_t k = 0; k < ntiles; ++k) {
+        b.begin[k] = run;
+        for (unsigned t = 0; t < nt; ++t) {
+            const std::size_t c = count[t][k];
+            count[t][k] = run;
+            run += c;
+        }
+    }
+    b.begin[ntiles] = run;
+
+    parallel_for_chunks(n, nt, [&](std::size_t lo, std::size_t hi, unsigned t) {
+        std::vector<std::size_t>& slot = count[t];
+        for (std::size_t i = lo; i < hi; ++i) b.order[slot[tile_of[i]]++] = i;
+    });
+    return b;
+}
+
+// Reorder the particles by tile (p.permute(b.order)): kernels then stream through memory
+// tile by tile. Afterwards b.order is the identity and b.cell follows the new order.
+template <typename Particles, unsigned Dim>
+void sort_particles(Particles& p, TileBins<Dim>& b, unsigned nthreads = 0) {
+    if (b.order.size() != p.size()) throw std::invalid_argument("sort_particles: bins are for another particle count");
+    p.permute(b.order, nthreads);
+    std::vector<std::size_t> cell(b.cell.size());
+    for (std::size_t i = 0; i < cell.size(); ++i) cell[i] = b.cell[b.order[i]];
+    b.cell = std::move(cell);
+    for (std::size_t i = 0; i < b.order.size(); ++i) b.order[i] = i;
+}
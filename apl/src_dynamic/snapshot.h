@@ -0,0 +1,226 @@
+#pragma once
+#include "Vis_forward.h"
+#include "descriptor.h"
+
+#include <atomic>
+
+// Copy-on-write field snapshots for asynchronous consumers.
+//
+// Storage is a table of fixed-size chunks held by shared_ptr (CowBuffer<T>).
+// - snapshot() copies one shared_ptr to the chunk table: O(1), no data copied.
+// - The first write after a snapshot clones the table (chunk pointers only), and each
+//   chunk is duplicated only on its first write while a snapshot still references it.
+//   Chunks that are not written are shared between the live buffer and all snapshots.
+// - Snapshots may be copied to and released on any thread. The writer only needs
+//   reference counts to decide whether to copy, so release needs no coordination.
+//   (A release racing with a write may cause one unnecessary copy, never a torn read.)
+// - Single writer: write_chunk()/snapshot() are called from the simulation thread.
+
+inline constexpr std::size_t apl_cow_default_chunk_bytes = 64 * 1024;
+
+template <typename T>
+class FieldSnapshot;
+
+template <typename T>
+class CowBuffer {
+public:
+    using Chunk = std::shared_ptr<T[]>;
+    struct Table {
+        std::vector<Chunk> chunks;
+    };
+
+private:
+    std::shared_ptr<Table> m_table;
+    std::size_t m_size = 0;
+    std::size_t m_chunk = 1;
+    std::size_t m_chunks_copied = 0;  // statistics: chunk duplications caused by live snapshots
+    std::size_t m_tables_copied = 0;
+
+    static bool shared(long use_count) noexcept {
+        if (use_count > 1) return true;
+        // Pairs with the release decrement of the last other owner (possibly on another thread).
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return false;
+    }
+
+public:
+    CowBuffer() : m_table(std::make_shared<Table>()) {}
+
+    // n elements in chunks of chunk_elems elements (0: ~64 KiB chunks).
+    explicit CowBuffer(std::size_t n, T init = T{}, std::size_t chunk_elems = 0)
+        : m_table(std::make_shared<Table>()), m_size(n) {
+        m_chunk = chunk_elems ? chunk_elems : std::max<std::size_t>(1, apl_cow_default_chunk_bytes / sizeof(T));
+        const std::size_t nc = (n + m_chunk - 1) / m_chunk;
+        m_table->chunks.reserve(nc);
+        for (std::size_t c = 0; c < nc; ++c) {
+            Chunk ch(new T[m_chunk]);
+            std::fill(ch.get(), ch.get() + m_chunk, init);
+            m_table->chunks.push_back(std::move(ch));
+        }
+    }
+
+    std::size_t size() const noexcept { return m_size; }
+    std::size_t chunk_size() const noexcept { return m_chunk; }
+    std::size_t num_chunks() const noexcept { return m_table->chunks.size(); }
+    // Elements in chunk c (the last chunk may be partial).
+    std::size_t chunk_extent(std::size_t c) const noexcept { return std::min(m_chunk, m_size - c * m_chunk); }
+
+    const T* read_chunk(std::size_t c) const { return m_table->chunks[c].get(); }
+    const T& operator[](std::size_t i) const { return m_table->chunks[i / m_chunk][i % m_chunk]; }
+
+    // Writable pointer to chunk c; copies the chunk first if a snapshot still references it.
+    T* write_chunk(std::size_t c) {
+        if (shared(m_table.use_count())) {
+            m_table = std::make_shared<Table>(*m_table);
+            ++m_tables_copied;
+        }
+        Chunk& ch = m_table->chunks[c];
+        if (shared(ch.use_count())) {
+            Chunk fresh(new T[m_chunk]);
+            std::copy(ch.get(), ch.get() + m_chunk, fresh.get());
+            ch = std::move(fresh);
+            ++m_chunks_copied;
+        }
+        return ch.get();
+    }
+
+    // Element write (convenience; prefer write_chunk() in loops).
+    T& write(std::size_t i) { return write_chunk(i / m_chunk)[i % m_chunk]; }
+
+    std::shared_ptr<const Table> share_table() const noexcept { return m_table; }
+
+    std::size_t chunks_copied() const noexcept { return m_chunks_copied; }
+    std::size_t tables_copied() const noexcept { return m_tables_copied; }
+    void reset_stats() noexcept { m_chunks_copied = m_tables_copied = 0; }
+};
+
+
+
+// Type-erased read-only snapshot, e.g. handed to a consumer thread.
+class FieldSnapshotBase {
+public:
+    std::string field_ID;
+    std::uint64_t version = 0;  // Field_b::version at snapshot time
+
+    virtual ~FieldSnapshotBase() = default;
+    virtual std::size_t num_chunks() const = 0;
+    // Zero-copy view of chunk c; keepalive holds the chunk, so it outlives the snapshot.
+    virtual DataDescriptor describe_chunk(std::size_t c) const = 0;
+};
+
+template <typename T>
+class FieldSnapshot : public FieldSnapshotBase {
+    using Table = typename CowBuffer<T>::Table;
+    std::shared_ptr<const Table> m_table;
+    std::size_t m_size = 0;
+    std::size_t m_chunk = 1;
+
+public:
+    FieldSnapshot() = default;
+    explicit FieldSnapshot(const CowBuffer<T>& buf)
+        : m_table(buf.share_table()), m_size(buf.size()), m_chunk(buf.chunk_size()) {}
+
+    bool empty() const noexcept { return !m_table; }
+    std::size_t size() const noexcept { return m_size; }
+    std::size_t chunk_size() const noexcept { return m_chunk; }
+    std::size_t num_chunks() const override { return m_table ? m_table->chunks.size() : 0; }
+    std::size_t chunk_extent(std::size_t c) const noexcept { return std::min(m_chunk, m_size - c * m_chunk); }
+
+    const T* read_chunk(std::size_t c) const { return m_table->chunks[c].get(); }
+    const T& operator[](std::size_t i) const { return m_table->chunks[i / m_chunk][i % m_chunk]; }
+
+    // Drop the reference (any thread); chunks no longer shared stop being copied on write.
+    void release() noexcept { m_table.reset(); }
+
+    DataDescriptor describe_chunk(std::size_t c) const override {
+        DataDescriptor d = describe_contiguous(read_chunk(c), static_cast<std::int64_t>(chunk_extent(c)));
+        d.keepalive = std::shared_ptr<const void>(m_table->chunks[c], m_table->chunks[c].get());
+        return d;
+    }
+
+    // Copy the snapshot into contiguous storage (out must hold size() elements).
+    void copy_to(T* out) const {
+        for (std::size_t c = 0; c < num_chunks(); ++c) {
+            const T* src = read_chunk(c);
+            std::copy(src, src + chunk_extent(c), out + c * m_chunk);
+        }
+    }
+};
+
+
+
+// Fields whose storage supports O(1) snapshots.
+class Snapshottable {
+public:
+    virtual ~Snapshottable() = default;
+    virtual std::shared_ptr<const FieldSnapshotBase> snapshot_erased() const = 0;
+};
+
+// Dim-dimensional grid field of T (axis 0 fastest) on chunked copy-on-write storage.
+template <typename T, unsigned Dim>
+class CowField : public Field_b, public Snapshottable {
+public:
+    using value_type = T;
+    std::array<std::size_t, Dim> extents{};
+    CowBuffer<T> storage;
+
+    CowField() = default;
+    CowField(std::string name, std::array<std::size_t, Dim> ext, T init = T{}, std::size_t chunk_elems = 0)
+        : extents(ext), storage(count(ext), init, chunk_elems) {
+        field_ID = std::move(name);
+    }
+
+    static std::size_t count(const std::array<std::size_t, Dim>& ext) {
+        std::size_t n = 1;
+        for (auto e : ext) n *= e;
+        return n;
+    }
+
+    std::size_t size() const noexcept { return storage.size(); }
+
+    size_t getTypeHash() const override { return typeid(T).hash_code(); }
+    size_t getDim() const override { return Dim; }
+
+    // Contiguous only when the storage is a single chunk; otherwise export per chunk
+    // through snapshot().describe_chunk(c).
+    DataDescriptor describe() const override {
+        if (storage.num_chunks() != 1) {
+            throw std::logic_error("CowField '" + field_ID + "': chunked storage has no single descriptor;"
+                                   " use snapshot().describe_chunk(c)");
+        }
+        DataDescriptor d = describe_contiguous(storage.read_chunk(0), static_cast<std::int64_t>(size()));
+        d.ndim = Dim;
+        std::int64_t stride = static_cast<std::int64_t>(sizeof(T));
+        for (unsigned a = 0; a < Dim; ++a) {
+            d.extents[a] = static_cast<std::int64_t>(extents[a]);
+            d.strides[a] = stride;
+            stride *= d.extents[a];
+        }
+        d.owner = lifetime.weak();
+        return d;
+    }
+
+    FieldSnapshot<T> snapshot() const {
+        FieldSnapshot<T> s(storage);
+        s.field_ID = field_ID;
+        s.version = version;
+        return s;
+    }
+
+    std::shared_ptr<const FieldSnapshotBase> snapshot_erased() const override {
+        return std::make_shared<FieldSnapshot<T>>(snapshot());
+    }
+};
+
+// Snapshot every bound field that supports it (O(1) per field). The returned map can be
+// handed to a consumer thread and dropped there.
+using StepSnapshot = std::unordered_map<std::string, std::shared_ptr<const FieldSnapshotBase>>;
+
+template <typename Registry>
+StepSnapshot snapshot_registry(const Registry& reg) {
+    StepSnapshot out;
+    reg.for_each_field([&](const std::string& name, Field_b& f) {
+        if (auto* s = dynamic_cast<const Snapshottable*>(&f)) out.emplace(name, s->snapshot_erased());
+    });
+    return out;
+}
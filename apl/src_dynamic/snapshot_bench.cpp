@@ -0,0 +1,144 @@
+// Memory / time overhead of copy-on-write snapshots (snapshot.h).
+//
+// Per step: take a snapshot, hand it to a consumer thread that reads it and keeps it
+// alive until the simulation finished writing (worst case: every write while the
+// snapshot is live), modify a fraction of the field, release.
+// Patterns: "block" (one contiguous region of the fraction, moving every step) and
+// "scattered" (every k-th element, so the same fraction touches every chunk).
+//
+// Usage: ./bild/snapshot_bench [n_elements=8388608] [steps=10]
+
+constexpr unsigned Dim = 3;
+using T = double;
+#include "bpl.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+
+using clk = std::chrono::steady_clock;
+
+static volatile double g_sink = 0.0;  // keeps the consumer's read loop alive
+
+static double ms_since(clk::time_point t0) {
+    return std::chrono::duration<double, std::milli>(clk::now() - t0).count();
+}
+
+// Modify `fraction` of the field; returns nothing, timing is done by the caller.
+static void modify(CowField<double, 1>& f, double fraction, bool scattered, int step) {
+    auto& buf = f.storage;
+    const std::size_t n = buf.size();
+    const std::size_t cs = buf.chunk_size();
+    if (scattered) {
+        const std::size_t k = std::max<std::size_t>(1, static_cast<std::size_t>(1.0 / fraction));
+        for (std::size_t c = 0; c < buf.num_chunks(); ++c) {
+            const std::size_t b = c * cs, e = b + buf.chunk_extent(c);
+            std::size_t i = ((b + k - 1) / k) * k;  // first multiple of k in the chunk
+            if (i >= e) continue;
+            double* p = buf.write_chunk(c);
+            for (; i < e; i += k) p[i - b] += 1.0;
+        }
+    } else {
+        const std::size_t len = static_cast<std::size_t>(fraction * static_cast<double>(n));
+        const std::size_t start = (static_cast<std::size_t>(step) * len) % n;
+        for (std::size_t j = 0; j < len;) {
+            const std::size_t i = (start + j) % n;
+            const std::size_t c = i / cs, off = i % cs;
+            const std::size_t run = std::min(len - j, buf.chunk_extent(c) - off);
+            double* p = buf.write_chunk(c);
+            for (std::size_t r = 0; r < run; ++r) p[off + r] += 1.0;
+            j += run;
+        }
+    }
+    f.touch();
+}
+
+struct Result {
+    double snap_us = 0, write_ms = 0, base_write_ms = 0, extra_mib = 0, extra_pct = 0;
+};
+
+static Result run(std::size_t n, std::size_t chunk_elems, double fraction, bool scattered, int steps) {
+    CowField<double, 1> f("bench", {n}, 1.0, chunk_elems);
+    const double field_mib = static_cast<double>(n * sizeof(double)) / (1024.0 * 1024.0);
+    Result r;
+
+    // Baseline: same writes without any live snapshot.
+    for (int s = 0; s < steps; ++s) {
+        auto t0 = clk::now();
+        modify(f, fraction, scattered, s);
+        r.base_write_ms += ms_since(t0);
+    }
+
+    for (int s = 0; s < steps; ++s) {
+        f.storage.reset_stats();
+
+        auto t0 = clk::now();
+        auto snap = std::make_shared<FieldSnapshot<double>>(f.snapshot());
+        r.snap_us += std::chrono::duration<double, std::micro>(clk::now() - t0).count();
+
+        std::mutex m;
+        std::condition_variable cv;
+        bool writer_done = false;
+        std::thread consumer([&, snap]() mutable {
+            double sum = 0.0;
+            for (std::size_t c = 0; c < snap->num_chunks(); ++c) {
+                const double* p = snap->read_chunk(c);
+                for (std::size_t i = 0; i < snap->chunk_extent(c); ++i) sum += p[i];
+            }
+            std::unique_lock<std::mutex> lk(m);
+            cv.wait(lk, [&] { return writer_done; });
+            snap.reset();  // released on the consumer thread
+            g_sink = sum;
+        });
+        snap.reset();  // the consumer holds the only reference now
+
+        t0 = clk::now();
+        modify(f, fraction, scattered, s);
+        r.write_ms += ms_since(t0);
+
+        const double extra = static_cast<double>(f.storage.chunks_copied() * chunk_elems * sizeof(double) +
+                                                 f.storage.tables_copied() * f.storage.num_chunks() *
+                                                     sizeof(typename CowBuffer<double>::Chunk));
+        r.extra_mib += extra / (1024.0 * 1024.0);
+        {
+            std::lock_guard<std::mutex> lk(m);
+            writer_done = true;
+        }
+        cv.notify_one();
+        consumer.join();
+    }
+
+    r.snap_us /= steps;
+    r.write_ms /= steps;
+    r.base_write_ms /= steps;
+    r.extra_mib /= steps;
+    r.extra_pct = 100.0 * r.extra_mib / field_mib;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoull(argv[1]) : (std::size_t{1} << 23);
+    const int steps = argc > 2 ? std::stoi(argv[2]) : 10;
+
+    std::cout << "field: " << n << " doubles (" << (n * sizeof(double)) / (1024 * 1024) << " MiB), steps: " << steps << "\n";
+    std::cout << std::left << std::setw(10) << "chunk" << std::setw(11) << "pattern" << std::setw(9) << "modified"
+              << std::right << std::setw(12) << "snap [us]" << std::setw(15) << "write [ms]" << std::setw(15)
+              << "no-snap [ms]" << std::setw(14) << "extra [MiB]" << std::setw(10) << "extra %" << "\n";
+
+    for (std::size_t chunk_bytes : {std::size_t{4} << 10, std::size_t{64} << 10, std::size_t{1} << 20}) {
+        const std::size_t chunk_elems = chunk_bytes / sizeof(double);
+        for (bool scattered : {false, true}) {
+            for (double fraction : {0.05, 0.5}) {
+                Result r = run(n, chunk_elems, fraction, scattered, steps);
+                std::cout << std::left << std::setw(10) << (std::to_string(chunk_bytes >> 10) + "KiB")
+                          << std::setw(11) << (scattered ? "scattered" : "block")
+                          << std::setw(9) << (std::to_string(static_cast<int>(fraction * 100)) + "%")
+                          << std::right << std::fixed << std::setprecision(2)
+                          << std::setw(12) << r.snap_us << std::setw(15) << r.write_ms << std::setw(15)
+                          << r.base_write_ms << std::setw(14) << r.extra_mib << std::setw(10) << r.extra_pct << "\n";
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Weak / strong scaling sweep of the mini apps in benchmark mode (no sleep, per-phase CSV).
+#
+#   MODE=weak   : CELLS is the block per rank (--cells-per-rank), global size grows with NP
+#   MODE=strong : CELLS is the global mesh (--cells), fixed for all NP
+#
+# Every (app, NP, CELLS) run appends to ${CSV}. Without CATALYST_IMPLEMENTATION_NAME the
+# Catalyst stub implementation is used, i.e. only the simulation-side adaptor cost is measured;
+# CATALYST_IMPL=mini selects the stand-in implementation built here (data is read once).
+#
+#   MODE=strong RANKS="1 2 4 8" CELLS="128 256" ./run_scaling.sh
+
+: "${MODE:=weak}"
+: "${RANKS:=1 2 4}"
+: "${CELLS:=32 64}"
+: "${APPS:=uniform_mini explicit_mini}"
+: "${STEPS:=20}"
+: "${FIELDS:=1}"
+: "${WORK:=10}"
+: "${BUILD_DIR:=build}"
+: "${MPIEXEC:=mpiexec}"
+: "${MPIEXEC_FLAGS:=}"
+: "${CSV:=scaling_${MODE}.csv}"
+
+case "${MODE}" in
+  weak)   SIZE_OPT="--cells-per-rank" ;;
+  strong) SIZE_OPT="--cells" ;;
+  *) echo "MODE must be weak or strong" >&2; exit 1 ;;
+esac
+
+if [ "${CATALYST_IMPL:-}" = "mini" ]; then
+  export CATALYST_IMPLEMENTATION_PATHS="${BUILD_DIR}/lib/catalyst"
+  export CATALYST_IMPLEMENTATION_NAME="mini"
+fi
+
+for app in ${APPS}; do
+  EXE="${BUILD_DIR}/${app}"
+  if [ ! -x "${EXE}" ]; then
+    echo "Executable ${EXE} not found. Run ./compile.sh first." >&2
+    exit 1
+  fi
+done
+
+echo "Scaling sweep: mode=${MODE} ranks=[${RANKS}] cells=[${CELLS}] apps=[${APPS}] -> ${CSV}"
+for app in ${APPS}; do
+  for cells in ${CELLS}; do
+    for np in ${RANKS}; do
+      echo "--- ${app} np=${np} ${SIZE_OPT} ${cells}"
+      # shellcheck disable=SC2086
+      "${MPIEXEC}" ${MPIEXEC_FLAGS} -np "${np}" "${BUILD_DIR}/${app}" \
+        "${SIZE_OPT}" "${cells}" --steps "${STEPS}" --fields "${FIELDS}" --work "${WORK}" --csv "${CSV}"
+    done
+  done
+done
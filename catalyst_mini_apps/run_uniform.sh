@@ -6,14 +6,20 @@ set -euo pipefail
 # : "${PV_PREFIX:=/<PATH_TO_Paraview>/ParaView-5.12.0-MPI-Linux-Python3.10-x86_64}"
 : "${PV_PREFIX:=/<PATH_TO_Paraview>/ParaView-5.13.2-MPI-Linux-Python3.10-x86_64}"
 
-# Catalyst implementation (ParaView)
-export CATALYST_IMPLEMENTATION_PATHS="${PV_PREFIX}/lib/catalyst"
-export CATALYST_IMPLEMENTATION_NAME="paraview"
-
-# Use ParaView's mpiexec to avoid MPI mismatches
-MPIEXEC="${PV_PREFIX}/lib/mpiexec"
+# Catalyst implementation: ParaView (default) or the stand-in built here (CATALYST_IMPL=mini)
+: "${CATALYST_IMPL:=paraview}"
+if [ "${CATALYST_IMPL}" = "mini" ]; then
+  export CATALYST_IMPLEMENTATION_PATHS="$(pwd)/build/lib/catalyst"
+  export CATALYST_IMPLEMENTATION_NAME="mini"
+  : "${MPIEXEC:=mpiexec}"
+else
+  export CATALYST_IMPLEMENTATION_PATHS="${PV_PREFIX}/lib/catalyst"
+  export CATALYST_IMPLEMENTATION_NAME="paraview"
+  # Use ParaView's mpiexec to avoid MPI mismatches
+  MPIEXEC="${PV_PREFIX}/lib/mpiexec"
+fi
 
-# Ranks (override with: NP=4 ./run_uniform.sh)
+# Ranks (override with: NP=4 ./run_uniform.sh); extra arguments go to the mini app
 : "${NP:=2}"
 
 # Build dir and executable
@@ -29,8 +35,8 @@ fi
 : "${CATALYST_PIPELINE_PATH:=$(pwd)/src/mini_apps/pipeline_trivial.py}"
 export CATALYST_PIPELINE_PATH
 
-echo "Using PV at: ${PV_PREFIX}"
+echo "Using Catalyst implementation: ${CATALYST_IMPLEMENTATION_NAME} (${CATALYST_IMPLEMENTATION_PATHS})"
 echo "Using pipeline: ${CATALYST_PIPELINE_PATH}"
 echo "Launching ${NP} ranks..."
 
-"${MPIEXEC}" -np "${NP}" "${EXE}"
+"${MPIEXEC}" -np "${NP}" "${EXE}" "$@"
@@ -0,0 +1,317 @@
+// Stand-in Catalyst 2.0 implementation ("mini") for benchmarking without ParaView.
+//
+// Loaded like any other implementation:
+//   CATALYST_IMPLEMENTATION_PATHS=<build>/lib/catalyst CATALYST_IMPLEMENTATION_NAME=mini
+//
+// catalyst_execute walks every channel under catalyst/channels, optionally verifies mesh
+// channels against the Blueprint, and reads every numeric array once (checksum over all
+// elements, honouring offset/stride), so the data is consumed like a real pipeline would
+// touch it. Per execute it records the array bytes, the checksum and the latency; at
+// finalize rank 0 prints totals reduced over all ranks.
+//
+// Static geometry: a channel may tag data/coordsets/<n> and data/topologies/<n> with a
+// content version in <channel>/static/{coordsets,topologies}/<n> (PersistentChannel::
+// publish_static). A tagged subtree is read once per version; while the version is
+// unchanged its cached digest is reused and its bytes count as "reused", not consumed.
+//
+// Options (init params catalyst_mini/<key>, overridden by the environment):
+//   verify   CATALYST_MINI_VERIFY=1    Blueprint-verify mesh channels on every execute
+//   verbose  CATALYST_MINI_VERBOSE=1   one report line per execute (rank 0)
+//   cache    CATALYST_MINI_CACHE=0     ignore static tags (re-read the geometry every execute)
+//   delay    CATALYST_MINI_DELAY=S     sleep S seconds per execute, standing in for the
+//                                      rendering / analysis cost of a real pipeline
+//
+// catalyst_results fills catalyst_mini/{cycle,bytes,reused_bytes,arrays,checksum,latency}
+// with the numbers of the last execute.
+
+#include <catalyst.h>
+#include <catalyst_conduit.hpp>
+#include <catalyst_conduit_blueprint.hpp>
+
+#include "catalyst_impl_mini.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+
+#include <mpi.h>
+#ifdef MPI_VERSION
+#  define MINI_IMPL_HAVE_MPI 1
+#else
+#  define MINI_IMPL_HAVE_MPI 0
+#endif
+
+namespace
+{
+
+struct ExecuteStats
+{
+    int64_t cycle = -1;
+    uint64_t bytes = 0;
+    uint64_t reused_bytes = 0;  // static geometry served from the cache
+    uint64_t arrays = 0;
+    uint64_t checksum = 1469598103934665603ull;
+    double latency = 0.0;  // seconds
+};
+
+// What the "pipeline" derived from one version of a static subtree.
+struct StaticEntry
+{
+    int64_t version = 0;
+    uint64_t digest = 0;
+    uint64_t bytes = 0;
+    uint64_t arrays = 0;
+};
+
+struct MiniImpl
+{
+    bool verify = false;
+    bool verbose = false;
+    bool cache = true;
+    double delay = 0.0;
+    int rank = 0;
+#if MINI_IMPL_HAVE_MPI
+    MPI_Comm comm = MPI_COMM_NULL;
+#endif
+
+    ExecuteStats last;
+    uint64_t executes = 0;
+    uint64_t bytes_total = 0;
+    uint64_t reused_total = 0;
+    uint64_t verify_failures = 0;
+    double latency_total = 0.0;
+    double latency_max = 0.0;
+
+    std::map<std::string, StaticEntry> statics;  // key: <channel>/<kind>/<name>
+};
+
+MiniImpl g_impl;
+
+bool option(conduit_cpp::Node& params, const char* key, const char* env, bool defval)
+{
+    bool v = defval;
+    const std::string path = std::string("catalyst_mini/") + key;
+    if (params.has_path(path)) v = params[path].to_int64() != 0;
+    if (const char* e = std::getenv(env)) v = std::string(e) != "0";
+    return v;
+}
+
+double number_option(conduit_cpp::Node& params, const char* key, const char* env, double defval)
+{
+    double v = defval;
+    const std::string path = std::string("catalyst_mini/") + key;
+    if (params.has_path(path)) v = params[path].to_float64();
+    if (const char* e = std::getenv(env)) v = std::atof(e);
+    return v;
+}
+
+// Read every element of a numeric leaf once (1..8 byte elements, any stride).
+void consume_array(conduit_cpp::Node& leaf, ExecuteStats& s)
+{
+    const int64_t n = static_cast<int64_t>(leaf.dtype().number_of_elements());
+    const int64_t eb = static_cast<int64_t>(leaf.dtype().element_bytes());
+    const int64_t stride = static_cast<int64_t>(leaf.dtype().stride());
+    if (n <= 0 || eb <= 0 || eb > 8) return;
+
+    const auto* p = static_cast<const unsigned char*>(conduit_node_element_ptr(conduit_cpp::c_node(&leaf), 0));
+    uint64_t h = s.checksum;
+    for (int64_t i = 0; i < n; ++i, p += stride) {
+        uint64_t v = 0;
+        std::memcpy(&v, p, static_cast<std::size_t>(eb));
+        h = (h ^ v) * 1099511628211ull;
+    }
+    s.checksum = h;
+    s.bytes += static_cast<uint64_t>(n * eb);
+    ++s.arrays;
+}
+
+void walk(conduit_cpp::Node& node, ExecuteStats& s)
+{
+    const conduit_index_t nchild = node.number_of_children();
+    if (nchild == 0) {
+        const auto id = node.dtype().id();
+        if (id != CONDUIT_EMPTY_ID && id != CONDUIT_CHAR8_STR_ID) consume_array(node, s);
+        return;
+    }
+    for (conduit_index_t i = 0; i < nchild; ++i) {
+        conduit_cpp::Node c = node.child(i);
+        walk(c, s);
+    }
+}
+
+void mix(ExecuteStats& s, uint64_t v) { s.checksum = (s.checksum ^ v) * 1099511628211ull; }
+
+// Consume data/<kind>/<name> of a channel, going through the static cache when the
+// subtree carries a version tag. The digest is computed from a fresh seed so a cached
+// and a re-read subtree contribute the same value to the execute checksum.
+void consume_subtree(conduit_cpp::Node& ch, const std::string& kind, conduit_cpp::Node& sub, ExecuteStats& s)
+{
+    const std::string tag = "static/" + kind + "/" + sub.name();
+    if (!g_impl.cache || !ch.has_path(tag)) {
+        walk(sub, s);
+        return;
+    }
+    const int64_t version = ch[tag].to_int64();
+    const std::string key = ch.name() + "/" + kind + "/" + sub.name();
+    auto it = g_impl.statics.find(key);
+    if (it == g_impl.statics.end() || it->second.version != version) {
+        ExecuteStats fresh;
+        walk(sub, fresh);
+        it = g_impl.statics.insert_or_assign(key, StaticEntry{version, fresh.checksum, fresh.bytes, fresh.arrays}).first;
+        s.bytes += fresh.bytes;
+    } else {
+        s.reused_bytes += it->second.bytes;
+    }
+    const StaticEntry& e = it->second;
+    s.arrays += e.arrays;
+    mix(s, e.digest);
+}
+
+void consume_channel(conduit_cpp::Node& ch, conduit_cpp::Node& data, ExecuteStats& s)
+{
+    for (conduit_index_t i = 0; i < data.number_of_children(); ++i) {
+        conduit_cpp::Node c = data.child(i);
+        const std::string kind = c.name();
+        if (kind != "coordsets" && kind != "topologies") {
+            walk(c, s);
+            continue;
+        }
+        for (conduit_index_t j = 0; j < c.number_of_children(); ++j) {
+            conduit_cpp::Node sub = c.child(j);
+            consume_subtree(ch, kind, sub, s);
+        }
+    }
+}
+
+} // namespace
+
+enum catalyst_status catalyst_initialize_mini(const conduit_node* params)
+{
+    conduit_cpp::Node p = conduit_cpp::cpp_node(const_cast<conduit_node*>(params));
+    g_impl = MiniImpl{};
+    g_impl.verify = option(p, "verify", "CATALYST_MINI_VERIFY", false);
+    g_impl.verbose = option(p, "verbose", "CATALYST_MINI_VERBOSE", false);
+    g_impl.cache = option(p, "cache", "CATALYST_MINI_CACHE", true);
+    g_impl.delay = number_option(p, "delay", "CATALYST_MINI_DELAY", 0.0);
+
+#if MINI_IMPL_HAVE_MPI
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if (initialized) {
+        g_impl.comm = MPI_COMM_WORLD;
+        if (p.has_path("catalyst/mpi_comm")) {
+            g_impl.comm = MPI_Comm_f2c(static_cast<MPI_Fint>(p["catalyst/mpi_comm"].to_int64()));
+        }
+        MPI_Comm_rank(g_impl.comm, &g_impl.rank);
+    }
+#endif
+
+    if (g_impl.rank == 0) {
+        std::cout << "[catalyst-mini] initialized (verify=" << g_impl.verify << ", verbose=" << g_impl.verbose
+                  << ", cache=" << g_impl.cache << ", delay=" << g_impl.delay << " s)\n";
+    }
+    return catalyst_status_ok;
+}
+
+enum catalyst_status catalyst_execute_mini(const conduit_node* params)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    conduit_cpp::Node p = conduit_cpp::cpp_node(const_cast<conduit_node*>(params));
+
+    ExecuteStats s;
+    if (p.has_path("catalyst/state/cycle")) s.cycle = p["catalyst/state/cycle"].to_int64();
+
+    if (p.has_path("catalyst/channels")) {
+        conduit_cpp::Node channels = p["catalyst/channels"];
+        for (conduit_index_t i = 0; i < channels.number_of_children(); ++i) {
+            conduit_cpp::Node ch = channels.child(i);
+            if (!ch.has_path("data")) continue;
+            conduit_cpp::Node data = ch["data"];
+
+            bool is_mesh = false;
+            if (ch.has_path("type")) {
+                conduit_cpp::Node type = ch["type"];
+                is_mesh = conduit_node_as_char8_str(conduit_cpp::c_node(&type)) == std::string("mesh");
+            }
+            if (g_impl.verify && is_mesh) {
+                conduit_cpp::Node info;
+                if (!conduit_cpp::Blueprint::verify("mesh", data, info)) {
+                    ++g_impl.verify_failures;
+                    std::cerr << "[catalyst-mini] rank " << g_impl.rank << ": channel '" << ch.name()
+                              << "' is not a valid Blueprint mesh (cycle " << s.cycle << ")\n";
+                    info.print();
+                }
+            }
+            consume_channel(ch, data, s);
+        }
+    }
+
+    if (g_impl.delay > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(g_impl.delay));
+
+    s.latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    g_impl.last = s;
+    ++g_impl.executes;
+    g_impl.bytes_total += s.bytes;
+    g_impl.reused_total += s.reused_bytes;
+    g_impl.latency_total += s.latency;
+    g_impl.latency_max = std::max(g_impl.latency_max, s.latency);
+
+    if (g_impl.verbose && g_impl.rank == 0) {
+        std::cout << "[catalyst-mini] cycle " << s.cycle << ": " << s.arrays << " arrays, " << s.bytes << " B read, "
+                  << s.reused_bytes << " B reused, checksum "
+                  << std::hex << s.checksum << std::dec << ", " << 1e3 * s.latency << " ms\n";
+    }
+    return catalyst_status_ok;
+}
+
+enum catalyst_status catalyst_finalize_mini(const conduit_node* params)
+{
+    (void)params;
+    double local[4] = {static_cast<double>(g_impl.bytes_total), g_impl.latency_total, g_impl.latency_max,
+                       static_cast<double>(g_impl.reused_total)};
+    double sum[4] = {local[0], local[1], local[2], local[3]};
+    double mx[4] = {local[0], local[1], local[2], local[3]};
+    int nranks = 1;
+#if MINI_IMPL_HAVE_MPI
+    if (g_impl.comm != MPI_COMM_NULL) {
+        MPI_Comm_size(g_impl.comm, &nranks);
+        MPI_Reduce(local, sum, 4, MPI_DOUBLE, MPI_SUM, 0, g_impl.comm);
+        MPI_Reduce(local, mx, 4, MPI_DOUBLE, MPI_MAX, 0, g_impl.comm);
+    }
+#endif
+    if (g_impl.rank == 0) {
+        const double n = g_impl.executes ? static_cast<double>(g_impl.executes) : 1.0;
+        std::cout << "[catalyst-mini] " << g_impl.executes << " executes on " << nranks << " ranks: "
+                  << sum[0] / n / (1024.0 * 1024.0) << " MiB read + " << sum[3] / n / (1024.0 * 1024.0)
+                  << " MiB static reused per execute (all ranks), latency avg "
+                  << 1e3 * sum[1] / n / nranks << " ms, max " << 1e3 * mx[2] << " ms";
+        if (g_impl.verify) std::cout << ", verify failures (rank 0): " << g_impl.verify_failures;
+        std::cout << "\n";
+    }
+    return catalyst_status_ok;
+}
+
+enum catalyst_status catalyst_about_mini(conduit_node* params)
+{
+    conduit_cpp::Node p = conduit_cpp::cpp_node(params);
+    p["catalyst/implementation"].set("mini");
+    return catalyst_status_ok;
+}
+
+enum catalyst_status catalyst_results_mini(conduit_node* params)
+{
+    conduit_cpp::Node p = conduit_cpp::cpp_node(params);
+    p["catalyst_mini/cycle"].set(static_cast<int64_t>(g_impl.last.cycle));
+    p["catalyst_mini/bytes"].set(static_cast<int64_t>(g_impl.last.bytes));
+    p["catalyst_mini/reused_bytes"].set(static_cast<int64_t>(g_impl.last.reused_bytes));
+    p["catalyst_mini/arrays"].set(static_cast<int64_t>(g_impl.last.arrays));
+    p["catalyst_mini/checksum"].set(static_cast<uint64_t>(g_impl.last.checksum));
+    p["catalyst_mini/latency"].set(g_impl.last.latency);
+    return catalyst_status_ok;
+}
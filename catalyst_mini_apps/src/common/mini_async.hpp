@@ -0,0 +1,319 @@
+// Asynchronous in-situ execution for the mini apps (--async).
+//
+// catalyst_execute runs on a dedicated thread while the simulation continues. The step's
+// data lives in one of `slots` buffer slots (double buffering with the default of 2): the
+// simulation claims a free slot with acquire(), copies its fields into it and hands it
+// over with publish(); the slot index travels through a lock-free single-producer /
+// single-consumer ring and the in-situ thread frees the slot after catalyst_execute.
+//
+// When every slot is busy the policy decides:
+//   block     wait for the in-situ thread (every frame is executed, in order)
+//   drop      skip this frame
+//   coalesce  overwrite the last published frame if it is queued but not started yet
+//             (newest data wins)
+// catalyst_execute is collective in a parallel pipeline, so every rank must execute the
+// same frames: drop/coalesce agree on the outcome with one MPI_Allreduce per step on a
+// private communicator (a frame is only coalesced if all ranks can, otherwise dropped).
+// Both threads may call MPI, which needs MPI_THREAD_MULTIPLE (mini_mpi_init).
+//
+// Slot states: Free -> Filling (simulation) -> Ready (queued) -> Executing -> Free.
+// The in-situ thread claims the slot at the front of the ring (Ready -> Executing) before
+// it pops it, so a slot it has taken is never Ready. Coalescing takes only the slot of the
+// last publish() from Ready back to Filling; every other queued frame is older and runs
+// first, so all ranks execute the same frames in the same order. If the in-situ thread
+// reaches a slot being coalesced it waits for Ready again; an index is queued once per
+// Ready phase.
+
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class AsyncPolicy { Off, Block, Drop, Coalesce };
+
+inline AsyncPolicy parse_async_policy(const std::string& s)
+{
+    if (s == "off") return AsyncPolicy::Off;
+    if (s == "block") return AsyncPolicy::Block;
+    if (s == "drop") return AsyncPolicy::Drop;
+    if (s == "coalesce") return AsyncPolicy::Coalesce;
+    throw std::invalid_argument("async: expected off, block, drop or coalesce, got '" + s + "'");
+}
+
+inline const char* async_policy_name(AsyncPolicy p)
+{
+    switch (p) {
+        case AsyncPolicy::Off: return "off";
+        case AsyncPolicy::Block: return "block";
+        case AsyncPolicy::Drop: return "drop";
+        case AsyncPolicy::Coalesce: return "coalesce";
+    }
+    return "unknown";
+}
+
+#ifdef MPI_VERSION
+// MPI_Init_thread at the level the run needs; returns the provided level.
+inline int mini_mpi_init(int* argc, char*** argv, bool threaded)
+{
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Init_thread(argc, argv, threaded ? MPI_THREAD_MULTIPLE : MPI_THREAD_SINGLE, &provided);
+    return provided;
+}
+#endif
+
+// Bounded lock-free ring for one producer and one consumer thread.
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(std::size_t capacity)
+    {
+        std::size_t n = 1;
+        while (n < capacity) n <<= 1;
+        m_buf.resize(n);
+        m_mask = n - 1;
+    }
+
+    bool push(const T& v)
+    {
+        const std::size_t t = m_tail.load(std::memory_order_relaxed);
+        if (t - m_head.load(std::memory_order_acquire) == m_buf.size()) return false;
+        m_buf[t & m_mask] = v;
+        m_tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: the next element without removing it.
+    bool front(T& v) const
+    {
+        const std::size_t h = m_head.load(std::memory_order_relaxed);
+        if (h == m_tail.load(std::memory_order_acquire)) return false;
+        v = m_buf[h & m_mask];
+        return true;
+    }
+
+    bool pop(T& v)
+    {
+        const std::size_t h = m_head.load(std::memory_order_relaxed);
+        if (h == m_tail.load(std::memory_order_acquire)) return false;
+        v = m_buf[h & m_mask];
+        m_head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> m_buf;
+    std::size_t m_mask = 0;
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+};
+
+class AsyncInSitu
+{
+public:
+    // Runs on the in-situ thread with the slot to publish; returns false on failure.
+    using Execute = std::function<bool(int slot)>;
+
+    struct Stats
+    {
+        uint64_t executed = 0;
+        uint64_t dropped = 0;
+        uint64_t coalesced = 0;
+        uint64_t failed = 0;
+        double blocked = 0.0;   // simulation thread waiting for a slot [s]
+        double busy = 0.0;      // in-situ thread inside execute [s]
+        double busy_max = 0.0;
+    };
+
+    AsyncInSitu(int slots, AsyncPolicy policy, Execute execute)
+        : m_policy(policy), m_execute(std::move(execute)), m_ring(static_cast<std::size_t>(slots)),
+          m_state(static_cast<std::size_t>(slots)), m_stolen(static_cast<std::size_t>(slots), false)
+    {
+        if (slots < 1 || policy == AsyncPolicy::Off) throw std::invalid_argument("AsyncInSitu: needs slots and a policy");
+        for (auto& s : m_state) s.store(Free);
+#ifdef MPI_VERSION
+        MPI_Comm_dup(MPI_COMM_WORLD, &m_comm);
+#endif
+        m_thread = std::thread([this] { run(); });
+    }
+
+    AsyncInSitu(const AsyncInSitu&) = delete;
+    AsyncInSitu& operator=(const AsyncInSitu&) = delete;
+
+    ~AsyncInSitu() { finish(); }
+
+    AsyncPolicy policy() const { return m_policy; }
+    int slots() const { return static_cast<int>(m_state.size()); }
+
+    // Claim a slot for the next frame; -1 if the frame is dropped (same answer on all ranks).
+    int acquire()
+    {
+        if (m_policy == AsyncPolicy::Block) {
+            const auto t0 = std::chrono::steady_clock::now();
+            int slot = -1;
+            for (;;) {
+                const uint64_t seen = m_released.load(std::memory_order_acquire);
+                if ((slot = reserve(AsyncPolicy::Block)) >= 0) break;
+                m_released.wait(seen, std::memory_order_acquire);
+            }
+            m_stats.blocked += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            return slot;
+        }
+
+        const int slot = reserve(m_policy);
+        const int kind = slot < 0 ? 0 : (m_stolen[static_cast<std::size_t>(slot)] ? 1 : 2);
+        int mm[2] = {kind, -kind};  // min and (negated) max over ranks
+#ifdef MPI_VERSION
+        MPI_Allreduce(MPI_IN_PLACE, mm, 2, MPI_INT, MPI_MIN, m_comm);
+#endif
+        if (mm[0] == 0 || mm[0] != -mm[1]) {
+            if (slot >= 0) {  // undo: a free slot goes back to Free, a coalesce target to Ready unchanged
+                m_state[static_cast<std::size_t>(slot)].store(kind == 1 ? Ready : Free, std::memory_order_release);
+                m_stolen[static_cast<std::size_t>(slot)] = false;
+            }
+            ++m_stats.dropped;
+            return -1;
+        }
+        if (kind == 1) ++m_stats.coalesced;
+        return slot;
+    }
+
+    // Hand a filled slot to the in-situ thread.
+    void publish(int slot)
+    {
+        const std::size_t s = static_cast<std::size_t>(slot);
+        m_state[s].store(Ready, std::memory_order_release);
+        m_last = slot;
+        if (m_stolen[s]) {  // still queued
+            m_stolen[s] = false;
+            return;
+        }
+        if (!m_ring.push(slot)) throw std::logic_error("AsyncInSitu: ring overflow");
+        m_queued.fetch_add(1, std::memory_order_release);
+        m_queued.notify_one();
+    }
+
+    // Execute failures so far (read on the simulation thread).
+    uint64_t failures() const { return m_failed.load(std::memory_order_acquire); }
+
+    // Execute the queued frames and join the thread; stats() is complete afterwards.
+    void finish()
+    {
+        if (!m_thread.joinable()) return;
+        m_stop.store(true, std::memory_order_release);
+        m_queued.fetch_add(1, std::memory_order_release);
+        m_queued.notify_one();
+        m_thread.join();
+        m_stats.failed = m_failed.load();
+#ifdef MPI_VERSION
+        MPI_Comm_free(&m_comm);
+#endif
+    }
+
+    const Stats& stats() const { return m_stats; }
+
+private:
+    enum State : int { Free, Filling, Ready, Executing };
+
+    int reserve(AsyncPolicy policy)
+    {
+        for (std::size_t s = 0; s < m_state.size(); ++s) {
+            int expected = Free;
+            if (m_state[s].compare_exchange_strong(expected, Filling, std::memory_order_acquire)) {
+                return static_cast<int>(s);
+            }
+        }
+        if (policy != AsyncPolicy::Coalesce || m_last < 0) return -1;
+        // only the newest frame: an older one would run after it
+        const std::size_t s = static_cast<std::size_t>(m_last);
+        int expected = Ready;
+        if (!m_state[s].compare_exchange_strong(expected, Filling, std::memory_order_acquire)) return -1;
+        m_stolen[s] = true;
+        return m_last;
+    }
+
+    void run()
+    {
+        for (;;) {
+            const uint64_t seen = m_queued.load(std::memory_order_acquire);
+            int slot = -1;
+            if (!m_ring.front(slot)) {
+                if (!m_stop.load(std::memory_order_acquire)) {
+                    m_queued.wait(seen, std::memory_order_acquire);
+                    continue;
+                }
+                if (!m_ring.front(slot)) break;
+            }
+            auto& state = m_state[static_cast<std::size_t>(slot)];
+            int expected = Ready;
+            while (!state.compare_exchange_weak(expected, Executing, std::memory_order_acquire)) {
+                expected = Ready;  // being coalesced: wait until the producer republishes
+                std::this_thread::yield();
+            }
+            m_ring.pop(slot);  // claimed before popping: the producer can no longer coalesce it
+
+            const auto t0 = std::chrono::steady_clock::now();
+            if (!m_execute(slot)) m_failed.fetch_add(1, std::memory_order_release);
+            const double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            m_stats.busy += dt;
+            m_stats.busy_max = std::max(m_stats.busy_max, dt);
+            ++m_stats.executed;
+
+            state.store(Free, std::memory_order_release);
+            m_released.fetch_add(1, std::memory_order_release);
+            m_released.notify_all();
+        }
+    }
+
+    AsyncPolicy m_policy;
+    Execute m_execute;
+    SpscRing<int> m_ring;
+    std::vector<std::atomic<int>> m_state;
+    std::vector<bool> m_stolen;  // simulation thread only
+    int m_last = -1;             // slot of the last publish(); simulation thread only
+    std::atomic<uint64_t> m_queued{0};
+    std::atomic<uint64_t> m_released{0};
+    std::atomic<uint64_t> m_failed{0};
+    std::atomic<bool> m_stop{false};
+    Stats m_stats;  // executed/busy: in-situ thread; the rest: simulation thread
+    std::thread m_thread;
+#ifdef MPI_VERSION
+    MPI_Comm m_comm = MPI_COMM_NULL;
+#endif
+};
+
+// Rank 0 prints the loop wall time (max over ranks), the simulation throughput and, in
+// async mode, the frame counters and the in-situ thread load.
+inline void report_throughput(const std::string& app, int steps, double loop_wall, double drain,
+                              const AsyncInSitu* insitu)
+{
+    AsyncInSitu::Stats s;
+    if (insitu) s = insitu->stats();
+    double local[5] = {loop_wall, drain, s.blocked, s.busy, s.busy_max}, mx[5];
+    std::copy(local, local + 5, mx);
+    int rank = 0;
+#ifdef MPI_VERSION
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Reduce(local, mx, 5, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+#endif
+    if (rank != 0) return;
+    std::cout << app << ": " << steps << " steps in " << mx[0] << " s = " << (mx[0] > 0.0 ? steps / mx[0] : 0.0)
+              << " steps/s (slowest rank, " << (insitu ? async_policy_name(insitu->policy()) : "synchronous")
+              << " in-situ)\n";
+    if (insitu) {
+        std::cout << "  frames executed " << s.executed << ", dropped " << s.dropped << ", coalesced " << s.coalesced
+                  << " (rank 0); max over ranks: blocked " << mx[2] << " s, in-situ thread busy " << mx[3]
+                  << " s (longest execute " << 1e3 * mx[4] << " ms), drain after the loop " << mx[1] << " s\n";
+    }
+}
@@ -0,0 +1,194 @@
+// Benchmark support for the mini apps: synthetic compute kernel and per-phase timing.
+//
+// PhaseLog records the wall time of every phase of every step on each rank. Nothing is
+// communicated during the run; write_csv() reduces min / avg / max over ranks once at
+// the end (three MPI_Reduce calls) and rank 0 appends one row per step and phase:
+//
+//   app,ranks,px,py,pz,cells_x,cells_y,cells_z,fields,work,step,phase,min_s,avg_s,max_s
+//
+// so runs of a sweep can share one file.
+
+#pragma once
+
+#include <mpi.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "mini_config.hpp"
+#include "mini_decomp.hpp"
+
+enum class Phase : int { Compute, FieldUpdate, NodeBuild, Verify, Execute, Step, Count };
+
+inline const char* phase_name(Phase p)
+{
+    switch (p) {
+        case Phase::Compute: return "compute";
+        case Phase::FieldUpdate: return "field_update";
+        case Phase::NodeBuild: return "node_build";
+        case Phase::Verify: return "verify";
+        case Phase::Execute: return "execute";
+        case Phase::Step: return "step";
+        case Phase::Count: break;
+    }
+    return "unknown";
+}
+
+class PhaseLog
+{
+public:
+    using clock = std::chrono::steady_clock;
+    static constexpr int num_phases = static_cast<int>(Phase::Count);
+
+    explicit PhaseLog(int steps) : m_steps(steps), m_t(static_cast<std::size_t>(steps) * num_phases, 0.0) {}
+
+    static clock::time_point now() { return clock::now(); }
+    static double since(clock::time_point t0) { return std::chrono::duration<double>(clock::now() - t0).count(); }
+
+    void add(int step, Phase p, double seconds) { m_t[index(step, p)] += seconds; }
+    double get(int step, Phase p) const { return m_t[index(step, p)]; }
+
+    // Local mean over all steps.
+    double mean(Phase p) const
+    {
+        double s = 0.0;
+        for (int i = 0; i < m_steps; ++i) s += get(i, p);
+        return m_steps ? s / m_steps : 0.0;
+    }
+    int steps() const { return m_steps; }
+
+    // Reduce over ranks and append to `path` (rank 0 writes; header only for a new file).
+    // Rank 0 also prints the per-phase means over all steps.
+    void write_csv(const std::string& path, const std::string& app, const MiniConfig& cfg, const CartDecomp& d) const
+    {
+        int rank = 0, size = 1;
+        std::vector<double> mn = m_t, mx = m_t, sum = m_t;
+#ifdef MPI_VERSION
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &size);
+        const int n = static_cast<int>(m_t.size());
+        MPI_Reduce(m_t.data(), mn.data(), n, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+        MPI_Reduce(m_t.data(), mx.data(), n, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(m_t.data(), sum.data(), n, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+#endif
+        if (rank != 0) return;
+
+        bool fresh = true;
+        {
+            std::ifstream probe(path);
+            fresh = !probe.good() || probe.peek() == std::ifstream::traits_type::eof();
+        }
+        std::ofstream out(path, std::ios::app);
+        if (!out) {
+            std::cerr << app << ": cannot open " << path << " for writing\n";
+            return;
+        }
+        if (fresh) out << "app,ranks,px,py,pz,cells_x,cells_y,cells_z,fields,work,step,phase,min_s,avg_s,max_s\n";
+        out << std::setprecision(9);
+        std::array<double, num_phases> mean_min{}, mean_avg{}, mean_max{};
+        for (int s = 0; s < m_steps; ++s) {
+            for (int p = 0; p < num_phases; ++p) {
+                const std::size_t i = index(s, static_cast<Phase>(p));
+                const double avg = sum[i] / size;
+                out << app << ',' << size << ',' << d.dims[0] << ',' << d.dims[1] << ',' << d.dims[2] << ','
+                    << d.global_cells[0] << ',' << d.global_cells[1] << ',' << d.global_cells[2] << ','
+                    << cfg.fields << ',' << cfg.work << ',' << s << ',' << phase_name(static_cast<Phase>(p)) << ','
+                    << mn[i] << ',' << avg << ',' << mx[i] << '\n';
+                mean_min[p] += mn[i] / m_steps;
+                mean_avg[p] += avg / m_steps;
+                mean_max[p] += mx[i] / m_steps;
+            }
+        }
+
+        std::cout << app << " per-step phase times over " << size << " ranks [ms] (min / avg / max):\n";
+        for (int p = 0; p < num_phases; ++p) {
+            std::cout << "  " << std::left << std::setw(14) << phase_name(static_cast<Phase>(p)) << std::right
+                      << std::fixed << std::setprecision(3) << std::setw(12) << 1e3 * mean_min[p] << std::setw(12)
+                      << 1e3 * mean_avg[p] << std::setw(12) << 1e3 * mean_max[p] << "\n";
+        }
+        const int step = static_cast<int>(Phase::Step);
+        const double insitu = mean_max[static_cast<int>(Phase::NodeBuild)] + mean_max[static_cast<int>(Phase::Verify)] +
+                              mean_max[static_cast<int>(Phase::Execute)];
+        if (mean_max[step] > 0.0) {
+            std::cout << "  in-situ share of the step (max over ranks): " << std::setprecision(1)
+                      << 100.0 * insitu / mean_max[step] << " %\n";
+        }
+        std::cout << std::defaultfloat;
+    }
+
+private:
+    std::size_t index(int step, Phase p) const
+    {
+        return static_cast<std::size_t>(step) * num_phases + static_cast<std::size_t>(p);
+    }
+
+    int m_steps;
+    std::vector<double> m_t;
+};
+
+// Stand-in for the simulation's own work: `sweeps` Jacobi sweeps of a 7-point stencil
+// over the local cell block (no halo exchange). Memory-bound and proportional to the
+// local mesh size, so weak scaling keeps the compute time per rank constant.
+class SyntheticKernel
+{
+public:
+    explicit SyntheticKernel(const CartDecomp& d)
+        : m_n{d.cell_count[0], d.cell_count[1], d.cell_count[2]},
+          m_u(static_cast<std::size_t>(d.local_cells()), 1.0),
+          m_v(m_u.size(), 0.0)
+    {
+        for (std::size_t i = 0; i < m_u.size(); ++i) m_u[i] = static_cast<double>(i % 17);
+    }
+
+    void run(int sweeps)
+    {
+        const int64_t nx = m_n[0], ny = m_n[1], nz = m_n[2];
+        const int64_t sy = nx, sz = nx * ny;
+        for (int s = 0; s < sweeps; ++s) {
+            for (int64_t k = 0; k < nz; ++k) {
+                for (int64_t j = 0; j < ny; ++j) {
+                    for (int64_t i = 0; i < nx; ++i) {
+                        const int64_t c = i + j * sy + k * sz;
+                        const double xm = i > 0 ? m_u[c - 1] : m_u[c], xp = i + 1 < nx ? m_u[c + 1] : m_u[c];
+                        const double ym = j > 0 ? m_u[c - sy] : m_u[c], yp = j + 1 < ny ? m_u[c + sy] : m_u[c];
+                        const double zm = k > 0 ? m_u[c - sz] : m_u[c], zp = k + 1 < nz ? m_u[c + sz] : m_u[c];
+                        m_v[c] = (xm + xp + ym + yp + zm + zp + 2.0 * m_u[c]) * 0.125;
+                    }
+                }
+            }
+            m_u.swap(m_v);
+        }
+        m_sweeps += sweeps;
+    }
+
+    double checksum() const
+    {
+        double s = 0.0;
+        for (double x : m_u) s += x;
+        return s;
+    }
+
+    // Rank 0 prints the sweep count and the checksum summed over ranks; reading the
+    // result keeps the sweeps from being optimised away.
+    void report(const std::string& app) const
+    {
+        int rank = 0;
+        double local = checksum(), sum = local;
+#ifdef MPI_VERSION
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Reduce(&local, &sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+#endif
+        if (rank == 0) std::cout << app << ": " << m_sweeps << " kernel sweeps, checksum " << sum << "\n";
+    }
+
+private:
+    std::array<int64_t, 3> m_n;
+    std::vector<double> m_u, m_v;
+    long m_sweeps = 0;
+};
@@ -0,0 +1,131 @@
+// Persistent Catalyst execute tree for the mini apps.
+//
+// The exec node (catalyst/state + one channel) is built once. The nodes that change per
+// step (cycle, time, field values) are resolved at construction / registration and kept
+// as raw conduit_node handles, so a step only writes two scalars and re-points the
+// external field arrays: no path parsing, no node allocation, no data copy.
+//
+// Structural changes (new fields, different mesh) go through data() / add_field(); the
+// handles stay valid as long as their nodes are not removed from the tree.
+//
+// Static geometry: publish_static() tags coordsets/topologies with a content version in
+// catalyst/channels/<channel>/static/<path> (outside "data", so Blueprint and ParaView
+// ignore it) and only rebuilds them when the version changes. Consumers that understand
+// the tag (the stand-in implementation) reuse what they derived from the previous version.
+
+#pragma once
+
+#include <catalyst.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Zero-copy: the node references `ptr`, which must stay alive until catalyst_execute returns.
+template <typename T>
+inline void set_external_values(conduit_cpp::Node node, const T* ptr, int64_t n,
+                                int64_t offset = 0, int64_t stride = static_cast<int64_t>(sizeof(T)))
+{
+    node.set_external(const_cast<T*>(ptr), n, offset, stride);
+}
+
+class PersistentChannel
+{
+public:
+    explicit PersistentChannel(const std::string& channel, const std::string& type = "mesh")
+    {
+        conduit_cpp::Node state = m_exec["catalyst/state"];
+        state["cycle"].set(static_cast<int32_t>(0));
+        state["time"].set(0.0);
+        state["domain_id"].set(static_cast<int32_t>(0));
+        m_cycle = handle(state["cycle"]);
+        m_time = handle(state["time"]);
+        m_domain = handle(state["domain_id"]);
+
+        conduit_cpp::Node ch = m_exec["catalyst/channels/" + channel];
+        ch["type"].set(type);
+        m_data = handle(ch["data"]);
+        m_channel = handle(ch);
+    }
+
+    PersistentChannel(const PersistentChannel&) = delete;
+    PersistentChannel& operator=(const PersistentChannel&) = delete;
+
+    // Channel "data" node: build the mesh here once (coordsets, topologies, ...).
+    conduit_cpp::Node data() const { return conduit_cpp::cpp_node(m_data); }
+
+    conduit_cpp::Node& exec() { return m_exec; }
+    const conduit_node* c_exec() const { return conduit_cpp::c_node(&m_exec); }
+
+    // Register fields/<name> with external values; returns the slot for set_field().
+    template <typename T>
+    std::size_t add_field(const std::string& name, const std::string& association, const std::string& topology,
+                          const T* ptr, int64_t n)
+    {
+        conduit_cpp::Node fld = data()["fields/" + name];
+        fld["association"].set(association);
+        fld["topology"].set(topology);
+        conduit_cpp::Node values = fld["values"];
+        set_external_values(values, ptr, n);
+        m_fields.push_back(handle(values));
+        return m_fields.size() - 1;
+    }
+
+    std::size_t num_fields() const { return m_fields.size(); }
+
+    // Run `build(data())` and tag `paths` (e.g. "coordsets/coords", "topologies/topo") with
+    // `version`, unless all of them already carry that version. Returns true if rebuilt.
+    template <typename Build>
+    bool publish_static(const std::vector<std::string>& paths, int64_t version, Build&& build)
+    {
+        bool current = !paths.empty();
+        for (const auto& p : paths) {
+            const auto it = m_static.find(p);
+            current = current && it != m_static.end() && it->second.version == version;
+        }
+        if (current) return false;
+
+        build(data());
+        conduit_cpp::Node ch = conduit_cpp::cpp_node(m_channel);
+        for (const auto& p : paths) {
+            StaticTag& tag = m_static[p];
+            if (!tag.node) tag.node = handle(ch["static/" + p]);
+            conduit_cpp::cpp_node(tag.node).set(version);
+            tag.version = version;
+        }
+        return true;
+    }
+
+    // Per-step updates.
+    void set_state(int cycle, double time, int domain_id)
+    {
+        conduit_cpp::cpp_node(m_cycle).set(static_cast<int32_t>(cycle));
+        conduit_cpp::cpp_node(m_time).set(time);
+        conduit_cpp::cpp_node(m_domain).set(static_cast<int32_t>(domain_id));
+    }
+
+    template <typename T>
+    void set_field(std::size_t slot, const T* ptr, int64_t n)
+    {
+        set_external_values(conduit_cpp::cpp_node(m_fields[slot]), ptr, n);
+    }
+
+private:
+    static conduit_node* handle(conduit_cpp::Node n) { return conduit_cpp::c_node(&n); }
+
+    conduit_cpp::Node m_exec;
+    conduit_node* m_cycle = nullptr;
+    conduit_node* m_time = nullptr;
+    conduit_node* m_domain = nullptr;
+    conduit_node* m_data = nullptr;
+    conduit_node* m_channel = nullptr;
+    std::vector<conduit_node*> m_fields;
+
+    struct StaticTag
+    {
+        int64_t version = 0;
+        conduit_node* node = nullptr;
+    };
+    std::map<std::string, StaticTag> m_static;
+};
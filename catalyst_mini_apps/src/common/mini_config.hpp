@@ -0,0 +1,306 @@
+// Run configuration shared by the mini apps.
+//
+// Every option can be given on the command line or through the environment; the
+// command line wins. Sizes are global cell counts (points = cells + 1 per axis).
+//
+//   --cells NX,NY,NZ | --cells N   MINI_CELLS           global cells per axis   (default 4,4,4)
+//   --cells-per-rank NX,NY,NZ | N  MINI_CELLS_PER_RANK  weak scaling: block per rank, the global
+//                                                       size follows the process grid
+//   --steps N                      MINI_STEPS           simulation steps        (default 20)
+//   --fields N                     MINI_FIELDS          element fields f, f1..  (default 1)
+//   --work N                       MINI_WORK            synthetic compute sweeps per step (default 0);
+//                                                       pic_mini: Jacobi iterations (0: 20)
+//   --sleep S                      MINI_SLEEP           seconds to sleep per step (default 1, 0 with --csv)
+//   --csv FILE                     MINI_CSV             benchmark mode: append per-phase timings to FILE
+//   --mesh MODE                    MINI_MESH            explicit_mini coordset/topology: unstructured
+//                                                       (default), mixed, rectilinear or structured
+//   --ghosts N                     MINI_GHOSTS          uniform_mini ghost cell layers per piece (default 1)
+//   --index auto|32|64             MINI_INDEX           explicit_mini connectivity index width
+//                                                       (default auto: 32 bit when it fits)
+//   --select NAMES                 MINI_SELECT          registry_mini: bindings to publish, e.g.
+//                                                       "E,rho", "p_*", "!phi" (default: all)
+//   --publish bridge|schema        MINI_PUBLISH         registry_mini: runtime bridge (default) or
+//                                                       compile-time schema binding
+//   --particles N                  MINI_PARTICLES       particles_mini, pic_mini: mean particles per rank
+//                                                       (default 1e6)
+//   --imbalance F                  MINI_IMBALANCE       particles_mini, pic_mini: counts vary linearly over the
+//                                                       ranks from (1-F)N to (1+F)N (default 0.5)
+//   --halo datatype|packed         MINI_HALO            pic_mini: ghost exchange via MPI subarray types
+//                                                       (default) or packed buffers (apl halo.h)
+//   --threads N                    MINI_THREADS         particles_mini, pic_mini: worker threads per rank
+//                                                       (default 0: hardware threads / ranks on the node)
+//   --keep N                       MINI_KEEP            particles_mini: publish N particles in total, split
+//                                                       over the ranks by particle count (default 0: all)
+//   --sample METHOD                MINI_SAMPLE          particles_mini: how --keep picks them: stride
+//                                                       (default), reservoir or importance (by energy)
+//   --async POLICY                 MINI_ASYNC           in-situ on its own thread: off (default),
+//                                                       block, drop or coalesce (common/mini_async.hpp)
+//   --budget F                     MINI_BUDGET          target in-situ share of the wall time, e.g. 0.05;
+//                                                       0 (default): in situ every step (common/mini_trigger.hpp)
+//   --must-fire S1,S2,...          MINI_MUST_FIRE       steps that always run in situ
+//   --trigger-log FILE             MINI_TRIGGER_LOG     CSV of the trigger decisions (rank 0)
+//   --help
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct MiniConfig
+{
+    std::array<int64_t, 3> cells{4, 4, 4};
+    bool cells_per_rank = false;  // `cells` is the block of one rank (weak scaling)
+    int steps = 20;
+    int fields = 1;
+    int work = 0;
+    double sleep = -1.0;          // < 0: default (1 s, or 0 in benchmark mode)
+    std::string csv;
+    std::string mesh = "unstructured";
+    int index_bits = 0;           // 0: auto
+    int ghosts = 1;
+    std::string select;
+    std::string publish = "bridge";
+    int64_t particles = 1000000;
+    double imbalance = 0.5;
+    std::string halo = "datatype";
+    int threads = 0;              // 0: hardware threads shared by the ranks of a node
+    int64_t keep = 0;             // 0: publish every particle
+    std::string sample = "stride";
+    std::string async = "off";
+    double budget = 0.0;
+    std::vector<int> must_fire;
+    std::string trigger_log;
+    bool help = false;
+
+    bool bench() const { return !csv.empty(); }
+
+    static void usage(std::ostream& os, const char* prog)
+    {
+        os << "usage: " << prog << " [--cells NX,NY,NZ | --cells N | --cells-per-rank NX,NY,NZ] [--steps N]\n"
+           << "       [--fields N] [--work N] [--sleep S] [--csv FILE]\n"
+           << "       [--async off|block|drop|coalesce] [--budget F] [--must-fire S1,S2,..] [--trigger-log FILE]\n"
+           << "       [--ghosts N]  (uniform_mini)\n"
+           << "       [--mesh unstructured|mixed|rectilinear|structured] [--index auto|32|64]  (explicit_mini)\n"
+           << "       [--select NAME,..] [--publish bridge|schema]  (registry_mini)\n"
+           << "       [--particles N] [--imbalance F] [--threads N]  (particles_mini, pic_mini)\n"
+           << "       [--halo datatype|packed]  (pic_mini)\n"
+           << "       [--keep N] [--sample stride|reservoir|importance]  (particles_mini)\n"
+           << "  environment: MINI_CELLS, MINI_CELLS_PER_RANK, MINI_STEPS, MINI_FIELDS, MINI_WORK,\n"
+           << "               MINI_SLEEP, MINI_CSV, MINI_ASYNC, MINI_BUDGET, MINI_MUST_FIRE, MINI_TRIGGER_LOG,\n"
+           << "               MINI_GHOSTS, MINI_MESH, MINI_INDEX, MINI_SELECT, MINI_PUBLISH,\n"
+           << "               MINI_PARTICLES, MINI_IMBALANCE, MINI_THREADS, MINI_HALO, MINI_KEEP, MINI_SAMPLE\n"
+           << "               (command line wins)\n";
+    }
+
+    // Throws std::invalid_argument on malformed input.
+    static MiniConfig parse(int argc, char** argv)
+    {
+        MiniConfig cfg;
+        if (const char* v = std::getenv("MINI_CELLS")) cfg.cells = parse_cells(v);
+        if (const char* v = std::getenv("MINI_CELLS_PER_RANK")) {
+            cfg.cells = parse_cells(v);
+            cfg.cells_per_rank = true;
+        }
+        if (const char* v = std::getenv("MINI_STEPS")) cfg.steps = static_cast<int>(parse_int(v, "MINI_STEPS"));
+        if (const char* v = std::getenv("MINI_FIELDS")) cfg.fields = static_cast<int>(parse_int(v, "MINI_FIELDS"));
+        if (const char* v = std::getenv("MINI_WORK")) cfg.work = static_cast<int>(parse_int(v, "MINI_WORK"));
+        if (const char* v = std::getenv("MINI_SLEEP")) cfg.sleep = parse_double(v, "MINI_SLEEP");
+        if (const char* v = std::getenv("MINI_CSV")) cfg.csv = v;
+        if (const char* v = std::getenv("MINI_MESH")) cfg.mesh = v;
+        if (const char* v = std::getenv("MINI_GHOSTS")) cfg.ghosts = static_cast<int>(parse_int(v, "MINI_GHOSTS"));
+        if (const char* v = std::getenv("MINI_INDEX")) cfg.index_bits = parse_index_bits(v);
+        if (const char* v = std::getenv("MINI_SELECT")) cfg.select = v;
+        if (const char* v = std::getenv("MINI_PUBLISH")) cfg.publish = v;
+        if (const char* v = std::getenv("MINI_PARTICLES")) cfg.particles = parse_count(v, "MINI_PARTICLES");
+        if (const char* v = std::getenv("MINI_IMBALANCE")) cfg.imbalance = parse_double(v, "MINI_IMBALANCE");
+        if (const char* v = std::getenv("MINI_THREADS")) cfg.threads = static_cast<int>(parse_int(v, "MINI_THREADS"));
+        if (const char* v = std::getenv("MINI_HALO")) cfg.halo = v;
+        if (const char* v = std::getenv("MINI_KEEP")) cfg.keep = parse_count(v, "MINI_KEEP");
+        if (const char* v = std::getenv("MINI_SAMPLE")) cfg.sample = v;
+        if (const char* v = std::getenv("MINI_ASYNC")) cfg.async = v;
+        if (const char* v = std::getenv("MINI_BUDGET")) cfg.budget = parse_double(v, "MINI_BUDGET");
+        if (const char* v = std::getenv("MINI_MUST_FIRE")) cfg.must_fire = parse_steps(v);
+        if (const char* v = std::getenv("MINI_TRIGGER_LOG")) cfg.trigger_log = v;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument("missing value for " + a);
+                return argv[++i];
+            };
+            if (a == "--cells") {
+                cfg.cells = parse_cells(value());
+                cfg.cells_per_rank = false;
+            } else if (a == "--cells-per-rank") {
+                cfg.cells = parse_cells(value());
+                cfg.cells_per_rank = true;
+            } else if (a == "--steps") {
+                cfg.steps = static_cast<int>(parse_int(value(), a));
+            } else if (a == "--fields") {
+                cfg.fields = static_cast<int>(parse_int(value(), a));
+            } else if (a == "--work") {
+                cfg.work = static_cast<int>(parse_int(value(), a));
+            } else if (a == "--sleep") {
+                cfg.sleep = parse_double(value(), a);
+            } else if (a == "--csv") {
+                cfg.csv = value();
+            } else if (a == "--mesh") {
+                cfg.mesh = value();
+            } else if (a == "--async") {
+                cfg.async = value();
+            } else if (a == "--budget") {
+                cfg.budget = parse_double(value(), a);
+            } else if (a == "--must-fire") {
+                cfg.must_fire = parse_steps(value());
+            } else if (a == "--trigger-log") {
+                cfg.trigger_log = value();
+            } else if (a == "--ghosts") {
+                cfg.ghosts = static_cast<int>(parse_int(value(), a));
+            } else if (a == "--index") {
+                cfg.index_bits = parse_index_bits(value());
+            } else if (a == "--select") {
+                cfg.select = value();
+            } else if (a == "--publish") {
+                cfg.publish = value();
+            } else if (a == "--particles") {
+                cfg.particles = parse_count(value(), a);
+            } else if (a == "--imbalance") {
+                cfg.imbalance = parse_double(value(), a);
+            } else if (a == "--threads") {
+                cfg.threads = static_cast<int>(parse_int(value(), a));
+            } else if (a == "--halo") {
+                cfg.halo = value();
+            } else if (a == "--keep") {
+                cfg.keep = parse_count(value(), a);
+            } else if (a == "--sample") {
+                cfg.sample = value();
+            } else if (a == "--help" || a == "-h") {
+                cfg.help = true;
+            } else {
+                throw std::invalid_argument("unknown option " + a);
+            }
+        }
+
+        for (int64_t c : cfg.cells) {
+            if (c < 1) throw std::invalid_argument("cells must be >= 1 per axis");
+        }
+        if (cfg.steps < 0) throw std::invalid_argument("steps must be >= 0");
+        if (cfg.fields < 1) throw std::invalid_argument("fields must be >= 1");
+        if (cfg.work < 0) throw std::invalid_argument("work must be >= 0");
+        if (cfg.ghosts < 0) throw std::invalid_argument("ghosts must be >= 0");
+        if (cfg.mesh != "unstructured" && cfg.mesh != "mixed" && cfg.mesh != "rectilinear" &&
+            cfg.mesh != "structured") {
+            throw std::invalid_argument("mesh must be unstructured, mixed, rectilinear or structured, got '" +
+                                        cfg.mesh + "'");
+        }
+        if (cfg.particles < 0) throw std::invalid_argument("particles must be >= 0");
+        if (!(cfg.imbalance >= 0.0 && cfg.imbalance <= 1.0)) throw std::invalid_argument("imbalance must be in [0, 1]");
+        if (cfg.threads < 0) throw std::invalid_argument("threads must be >= 0");
+        if (cfg.halo != "datatype" && cfg.halo != "packed") {
+            throw std::invalid_argument("halo must be datatype or packed, got '" + cfg.halo + "'");
+        }
+        if (cfg.keep < 0) throw std::invalid_argument("keep must be >= 0");
+        if (cfg.sample != "stride" && cfg.sample != "reservoir" && cfg.sample != "importance") {
+            throw std::invalid_argument("sample must be stride, reservoir or importance, got '" + cfg.sample + "'");
+        }
+        if (cfg.publish != "bridge" && cfg.publish != "schema") {
+            throw std::invalid_argument("publish must be bridge or schema, got '" + cfg.publish + "'");
+        }
+        if (cfg.async != "off" && cfg.async != "block" && cfg.async != "drop" && cfg.async != "coalesce") {
+            throw std::invalid_argument("async must be off, block, drop or coalesce, got '" + cfg.async + "'");
+        }
+        if (cfg.budget >= 1.0) throw std::invalid_argument("budget must be a fraction below 1");
+        if (cfg.sleep < 0.0) cfg.sleep = cfg.bench() ? 0.0 : 1.0;
+        return cfg;
+    }
+
+    static double parse_double(const std::string& s, const std::string& what)
+    {
+        std::size_t pos = 0;
+        double v = 0.0;
+        try {
+            v = std::stod(s, &pos);
+        } catch (const std::exception&) {
+            pos = 0;
+        }
+        if (pos == 0 || pos != s.size() || v < 0.0) {
+            throw std::invalid_argument("invalid non-negative number for " + what + ": '" + s + "'");
+        }
+        return v;
+    }
+
+    static int64_t parse_int(const std::string& s, const std::string& what)
+    {
+        std::size_t pos = 0;
+        long long v = 0;
+        try {
+            v = std::stoll(s, &pos);
+        } catch (const std::exception&) {
+            pos = 0;
+        }
+        if (pos == 0 || pos != s.size()) throw std::invalid_argument("invalid integer for " + what + ": '" + s + "'");
+        return static_cast<int64_t>(v);
+    }
+
+    // Integer or a number in scientific notation ("1e6").
+    static int64_t parse_count(const std::string& s, const std::string& what)
+    {
+        if (s.find_first_of("eE.") == std::string::npos) return parse_int(s, what);
+        const double v = parse_double(s, what);
+        if (v != static_cast<double>(static_cast<int64_t>(v))) {
+            throw std::invalid_argument("invalid count for " + what + ": '" + s + "'");
+        }
+        return static_cast<int64_t>(v);
+    }
+
+    // "auto" -> 0, "32", "64"
+    static int parse_index_bits(const std::string& s)
+    {
+        if (s == "auto") return 0;
+        if (s == "32") return 32;
+        if (s == "64") return 64;
+        throw std::invalid_argument("index: expected auto, 32 or 64, got '" + s + "'");
+    }
+
+    // "S1,S2,..." (non-negative step numbers)
+    static std::vector<int> parse_steps(const std::string& s)
+    {
+        std::vector<int> v;
+        std::stringstream ss(s);
+        std::string tok;
+        while (std::getline(ss, tok, ',')) {
+            const int64_t step = parse_int(tok, "must-fire");
+            if (step < 0) throw std::invalid_argument("must-fire: steps must be >= 0");
+            v.push_back(static_cast<int>(step));
+        }
+        return v;
+    }
+
+    // "N" (cube) or "NX,NY,NZ"
+    static std::array<int64_t, 3> parse_cells(const std::string& s)
+    {
+        std::vector<int64_t> v;
+        std::stringstream ss(s);
+        std::string tok;
+        while (std::getline(ss, tok, ',')) v.push_back(parse_int(tok, "cells"));
+        if (v.size() == 1) return {v[0], v[0], v[0]};
+        if (v.size() != 3) throw std::invalid_argument("cells: expected N or NX,NY,NZ, got '" + s + "'");
+        return {v[0], v[1], v[2]};
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const MiniConfig& c)
+{
+    os << (c.cells_per_rank ? "cells/rank=" : "cells=") << c.cells[0] << "x" << c.cells[1] << "x" << c.cells[2]
+       << " steps=" << c.steps << " fields=" << c.fields << " work=" << c.work << " sleep=" << c.sleep;
+    if (c.async != "off") os << " async=" << c.async;
+    if (c.budget > 0.0) os << " budget=" << c.budget;
+    if (c.bench()) os << " csv=" << c.csv;
+    return os;
+}
@@ -0,0 +1,164 @@
+// Unstructured connectivity for the logically structured mini-app grids.
+//
+// CellConnectivity<Index> holds the Blueprint "elements" arrays with an index type of
+// 32 or 64 bits; publish() references them zero-copy. With 32-bit indices the arrays
+// take half the memory and bandwidth, which is valid as long as every point id and
+// every connectivity offset fits (index_fits_int32()); that is the common case for a
+// per-rank block.
+//
+// Two layouts over a block of nx x ny x nz points:
+//   hex_connectivity    one hex per cell, elements/shape = "hex"
+//   mixed_connectivity  hex-dominant "mixed" topology (shapes/offsets/sizes + shape_map):
+//                       cells of the top layer are split into two wedges, cells of the
+//                       bottom x-min row into six tets, all others stay hexes
+// Elements are ordered by cell, so element_cell maps every element back to its cell for
+// expanding cell-centred values (expand_to_elements).
+
+#pragma once
+
+#include <catalyst.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "mini_channel.hpp"
+
+// VTK cell type ids, used as Blueprint shape_map values.
+enum class CellShape : int32_t { Tet = 10, Hex = 12, Wedge = 13 };
+
+inline bool index_fits_int32(int64_t num_points, int64_t connectivity_size)
+{
+    constexpr int64_t lim = std::numeric_limits<int32_t>::max();
+    return num_points <= lim && connectivity_size <= lim;
+}
+
+template <typename Index>
+struct CellConnectivity
+{
+    std::vector<Index> connectivity;
+    std::vector<Index> offsets;          // mixed only
+    std::vector<Index> sizes;            // mixed only
+    std::vector<int32_t> shapes;         // mixed only
+    std::vector<int64_t> element_cell;   // mixed only: source cell of every element
+    bool mixed = false;
+
+    int64_t num_elements() const
+    {
+        return mixed ? static_cast<int64_t>(shapes.size()) : static_cast<int64_t>(connectivity.size() / 8);
+    }
+
+    // Bytes published to Catalyst (element_cell stays on the simulation side).
+    std::size_t bytes() const
+    {
+        return (connectivity.size() + offsets.size() + sizes.size()) * sizeof(Index) + shapes.size() * sizeof(int32_t);
+    }
+
+    // Fill topo/elements (the caller sets type and coordset).
+    void publish(conduit_cpp::Node topo) const
+    {
+        set_external_values(topo["elements/connectivity"], connectivity.data(), static_cast<int64_t>(connectivity.size()));
+        if (!mixed) {
+            // Conduit blueprint expects singular shape names: "hex"
+            topo["elements/shape"].set("hex");
+            return;
+        }
+        topo["elements/shape"].set("mixed");
+        topo["elements/shape_map/tet"].set(static_cast<int32_t>(CellShape::Tet));
+        topo["elements/shape_map/hex"].set(static_cast<int32_t>(CellShape::Hex));
+        topo["elements/shape_map/wedge"].set(static_cast<int32_t>(CellShape::Wedge));
+        set_external_values(topo["elements/shapes"], shapes.data(), static_cast<int64_t>(shapes.size()));
+        set_external_values(topo["elements/sizes"], sizes.data(), static_cast<int64_t>(sizes.size()));
+        set_external_values(topo["elements/offsets"], offsets.data(), static_cast<int64_t>(offsets.size()));
+    }
+};
+
+namespace mini_detail
+{
+
+// Corner point ids of cell (i, j, k), VTK hex order (bottom face counter-clockwise, then top).
+inline void hex_corners(int64_t i, int64_t j, int64_t k, int64_t nx, int64_t ny, int64_t v[8])
+{
+    const int64_t sy = nx, sz = nx * ny, b = i + j * sy + k * sz;
+    v[0] = b;          v[1] = b + 1;
+    v[2] = b + 1 + sy; v[3] = b + sy;
+    v[4] = v[0] + sz;  v[5] = v[1] + sz;
+    v[6] = v[2] + sz;  v[7] = v[3] + sz;
+}
+
+} // namespace mini_detail
+
+template <typename Index>
+CellConnectivity<Index> hex_connectivity(int64_t nx, int64_t ny, int64_t nz)
+{
+    CellConnectivity<Index> c;
+    c.connectivity.resize(static_cast<std::size_t>((nx - 1) * (ny - 1) * (nz - 1) * 8));
+    std::size_t n = 0;
+    int64_t v[8];
+    for (int64_t k = 0; k + 1 < nz; ++k)
+        for (int64_t j = 0; j + 1 < ny; ++j)
+            for (int64_t i = 0; i + 1 < nx; ++i) {
+                mini_detail::hex_corners(i, j, k, nx, ny, v);
+                for (int64_t p : v) c.connectivity[n++] = static_cast<Index>(p);
+            }
+    return c;
+}
+
+template <typename Index>
+CellConnectivity<Index> mixed_connectivity(int64_t nx, int64_t ny, int64_t nz)
+{
+    // Sub-elements as corner indices into the hex; all positively oriented (VTK).
+    static constexpr int tets[6][4] = {{0, 1, 2, 6}, {0, 2, 3, 6}, {0, 3, 7, 6},
+                                       {0, 7, 4, 6}, {0, 4, 5, 6}, {0, 5, 1, 6}};
+    static constexpr int wedges[2][6] = {{0, 2, 1, 4, 6, 5}, {0, 3, 2, 4, 7, 6}};
+
+    CellConnectivity<Index> c;
+    c.mixed = true;
+    auto add = [&](CellShape shape, const int64_t* pts, int npts, int64_t cell) {
+        c.shapes.push_back(static_cast<int32_t>(shape));
+        c.offsets.push_back(static_cast<Index>(c.connectivity.size()));
+        c.sizes.push_back(static_cast<Index>(npts));
+        c.element_cell.push_back(cell);
+        for (int p = 0; p < npts; ++p) c.connectivity.push_back(static_cast<Index>(pts[p]));
+    };
+
+    const int64_t ex = nx - 1, ey = ny - 1, ez = nz - 1;
+    const std::size_t ncell = static_cast<std::size_t>(ex * ey * ez);
+    c.connectivity.reserve(ncell * 8);
+    c.shapes.reserve(ncell);
+    c.offsets.reserve(ncell);
+    c.sizes.reserve(ncell);
+    c.element_cell.reserve(ncell);
+
+    int64_t v[8], sub[8];
+    int64_t cell = 0;
+    for (int64_t k = 0; k < ez; ++k)
+        for (int64_t j = 0; j < ey; ++j)
+            for (int64_t i = 0; i < ex; ++i, ++cell) {
+                mini_detail::hex_corners(i, j, k, nx, ny, v);
+                if (k == 0 && i == 0) {
+                    for (const auto& t : tets) {
+                        for (int p = 0; p < 4; ++p) sub[p] = v[t[p]];
+                        add(CellShape::Tet, sub, 4, cell);
+                    }
+                } else if (k == ez - 1) {
+                    for (const auto& w : wedges) {
+                        for (int p = 0; p < 6; ++p) sub[p] = v[w[p]];
+                        add(CellShape::Wedge, sub, 6, cell);
+                    }
+                } else {
+                    add(CellShape::Hex, v, 8, cell);
+                }
+            }
+    return c;
+}
+
+// Element values from cell values (mixed layouts; a plain copy for one element per cell).
+template <typename T>
+inline void expand_to_elements(const std::vector<T>& cell_values, const std::vector<int64_t>& element_cell,
+                               std::vector<T>& element_values)
+{
+    for (std::size_t e = 0; e < element_cell.size(); ++e) {
+        element_values[e] = cell_values[static_cast<std::size_t>(element_cell[e])];
+    }
+}
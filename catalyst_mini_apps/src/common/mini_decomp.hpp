@@ -0,0 +1,226 @@
+// 3D block decomposition of a global cell grid over MPI ranks.
+//
+// MPI_Dims_create factors the rank count into a 3D process grid (the largest factor
+// goes to the axis with the most cells) and MPI_Cart_create builds the matching
+// communicator. If that grid puts more ranks on an axis than it has cells (e.g. 4x4x1
+// cells on 8 ranks), the factorization with the smallest cut area among those that fit
+// is used instead (2x4x1 there). Each rank owns a contiguous block of cells; neighbouring blocks share
+// their boundary point plane, as in the original two-rank split. Ranks keep their
+// MPI_COMM_WORLD numbering (no reordering), so domain_id == rank.
+//
+// create_weak() takes the block of one rank instead (weak scaling): the global grid is
+// the block times the process grid, so every rank owns exactly that block.
+//
+// ghosted(g) describes the piece a rank publishes with g ghost cell layers: the owned
+// block grown by up to g cells towards every neighbour (not beyond the global grid).
+
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct CartDecomp
+{
+    std::array<int64_t, 3> global_cells{1, 1, 1};
+    std::array<int, 3> dims{1, 1, 1};       // process grid
+    std::array<int, 3> coords{0, 0, 0};     // this rank in the process grid
+    std::array<int64_t, 3> cell_begin{0, 0, 0};
+    std::array<int64_t, 3> cell_count{1, 1, 1};
+    std::array<int64_t, 3> ghost_lo{0, 0, 0};   // ghost layers below / above the owned block
+    std::array<int64_t, 3> ghost_hi{0, 0, 0};
+#ifdef MPI_VERSION
+    MPI_Comm cart = MPI_COMM_NULL;
+#endif
+
+    int64_t points(int a) const { return cell_count[a] + 1; }
+    int64_t local_cells() const { return cell_count[0] * cell_count[1] * cell_count[2]; }
+    int64_t local_points() const { return points(0) * points(1) * points(2); }
+    int64_t global_cell_total() const { return global_cells[0] * global_cells[1] * global_cells[2]; }
+
+    // Global linear index of local cell (i, j, k), axis 0 fastest.
+    int64_t global_cell_index(int64_t i, int64_t j, int64_t k) const
+    {
+        return (cell_begin[0] + i) + global_cells[0] * ((cell_begin[1] + j) + global_cells[1] * (cell_begin[2] + k));
+    }
+
+    // Owned block plus up to g ghost layers per side; cell_begin/cell_count cover both.
+    CartDecomp ghosted(int64_t g) const
+    {
+        CartDecomp p = *this;
+        for (int a = 0; a < 3; ++a) {
+            p.ghost_lo[a] = std::min<int64_t>(g, cell_begin[a]);
+            p.ghost_hi[a] = std::min<int64_t>(g, global_cells[a] - (cell_begin[a] + cell_count[a]));
+            p.cell_begin[a] -= p.ghost_lo[a];
+            p.cell_count[a] += p.ghost_lo[a] + p.ghost_hi[a];
+        }
+        return p;
+    }
+
+    // Local cell (i, j, k) lies in a ghost layer.
+    bool is_ghost(int64_t i, int64_t j, int64_t k) const
+    {
+        const int64_t c[3] = {i, j, k};
+        for (int a = 0; a < 3; ++a) {
+            if (c[a] < ghost_lo[a] || c[a] >= cell_count[a] - ghost_hi[a]) return true;
+        }
+        return false;
+    }
+
+    // Cells [begin, begin + count) of axis a for process coordinate c out of d (first n % d get one more).
+    static void split(int64_t n, int d, int c, int64_t& begin, int64_t& count)
+    {
+        const int64_t base = n / d, rem = n % d;
+        count = base + (c < rem ? 1 : 0);
+        begin = c * base + std::min<int64_t>(c, rem);
+    }
+
+#ifdef MPI_VERSION
+    static bool fits(const std::array<int, 3>& dims, const std::array<int64_t, 3>& cells)
+    {
+        for (int a = 0; a < 3; ++a) {
+            if (cells[a] < dims[a]) return false;
+        }
+        return true;
+    }
+
+    // Process grid for `size` ranks; the largest factor goes to the axis with the most cells.
+    // With `fit`, a grid that does not fit the cells is replaced by the fitting factorization
+    // with the least cut area (sum over axes of (dims - 1) x cross-section); if none fits,
+    // the MPI_Dims_create grid is returned and create() reports the axis.
+    static std::array<int, 3> process_grid(int size, const std::array<int64_t, 3>& cells, bool fit = true)
+    {
+        int f[3] = {0, 0, 0};
+        MPI_Dims_create(size, 3, f);  // non-increasing
+        std::array<int, 3> order{0, 1, 2};
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return cells[a] > cells[b]; });
+        std::array<int, 3> dims{1, 1, 1};
+        for (int r = 0; r < 3; ++r) dims[order[r]] = f[r];
+        if (!fit || fits(dims, cells)) return dims;
+
+        const double total = static_cast<double>(cells[0]) * static_cast<double>(cells[1]) * static_cast<double>(cells[2]);
+        double best = -1.0;
+        std::array<int, 3> pick = dims;
+        for (int d0 = 1; d0 <= size; ++d0) {
+            if (size % d0) continue;
+            for (int d1 = 1; d1 <= size / d0; ++d1) {
+                if ((size / d0) % d1) continue;
+                const std::array<int, 3> g{d0, d1, size / d0 / d1};
+                if (!fits(g, cells)) continue;
+                double cut = 0.0;
+                for (int a = 0; a < 3; ++a) cut += (g[a] - 1) * (total / static_cast<double>(cells[a]));
+                if (best < 0.0 || cut < best) {
+                    best = cut;
+                    pick = g;
+                }
+            }
+        }
+        return pick;
+    }
+
+    static CartDecomp create(MPI_Comm comm, const std::array<int64_t, 3>& cells)
+    {
+        int size = 1, rank = 0;
+        MPI_Comm_size(comm, &size);
+        MPI_Comm_rank(comm, &rank);
+
+        CartDecomp d;
+        d.global_cells = cells;
+        d.dims = process_grid(size, cells);
+
+        for (int a = 0; a < 3; ++a) {
+            if (cells[a] < d.dims[a]) {
+                throw std::invalid_argument("CartDecomp: " + std::to_string(cells[a]) + " cells on axis " +
+                                            std::to_string(a) + " cannot be split over " +
+                                            std::to_string(d.dims[a]) + " ranks");
+            }
+        }
+
+        const int periods[3] = {0, 0, 0};
+        MPI_Cart_create(comm, 3, d.dims.data(), periods, /*reorder=*/0, &d.cart);
+        MPI_Cart_coords(d.cart, rank, 3, d.coords.data());
+        for (int a = 0; a < 3; ++a) split(cells[a], d.dims[a], d.coords[a], d.cell_begin[a], d.cell_count[a]);
+        return d;
+    }
+
+    static CartDecomp create_weak(MPI_Comm comm, const std::array<int64_t, 3>& per_rank)
+    {
+        int size = 1;
+        MPI_Comm_size(comm, &size);
+        const std::array<int, 3> dims = process_grid(size, per_rank, /*fit=*/false);  // any grid fits
+        return create(comm, {per_rank[0] * dims[0], per_rank[1] * dims[1], per_rank[2] * dims[2]});
+    }
+
+    void free()
+    {
+        if (cart != MPI_COMM_NULL) MPI_Comm_free(&cart);
+    }
+#endif
+
+    // Single-rank decomposition (no MPI).
+    static CartDecomp serial(const std::array<int64_t, 3>& cells)
+    {
+        CartDecomp d;
+        d.global_cells = cells;
+        d.cell_count = cells;
+        return d;
+    }
+};
+
+// vtkGhostType per local cell: 0 for owned cells, DUPLICATECELL (1) for ghost cells.
+inline void fill_ghost_types(std::vector<uint8_t>& ghost, const CartDecomp& d)
+{
+    constexpr uint8_t duplicate_cell = 1;  // vtkDataSetAttributes::DUPLICATECELL
+    std::size_t c = 0;
+    for (int64_t k = 0; k < d.cell_count[2]; ++k)
+        for (int64_t j = 0; j < d.cell_count[1]; ++j)
+            for (int64_t i = 0; i < d.cell_count[0]; ++i) ghost[c++] = d.is_ghost(i, j, k) ? duplicate_cell : 0;
+}
+
+// Element values of field `f` at `step`: global cell index + step (+ field offset), in
+// reversed order on odd steps, so the pattern is continuous across rank boundaries.
+inline void fill_cell_values(std::vector<int32_t>& vals, const CartDecomp& d, int step, int f = 0)
+{
+    const int64_t total = d.global_cell_total();
+    const bool reverse = (step % 2) != 0;
+    std::size_t c = 0;
+    for (int64_t k = 0; k < d.cell_count[2]; ++k)
+        for (int64_t j = 0; j < d.cell_count[1]; ++j)
+            for (int64_t i = 0; i < d.cell_count[0]; ++i) {
+                const int64_t g = d.global_cell_index(i, j, k);
+                vals[c++] = static_cast<int32_t>((reverse ? total - 1 - g : g) + step + 1000 * f);
+            }
+}
+
+// Particles of rank r out of p: the mean n scaled linearly from (1-f) to (1+f) over the
+// ranks (--particles / --imbalance of particles_mini and pic_mini).
+inline int64_t particles_of_rank(int64_t n, double f, int r, int p)
+{
+    if (p <= 1) return n;
+    const double scale = 1.0 + f * (2.0 * r / (p - 1) - 1.0);
+    return static_cast<int64_t>(std::llround(static_cast<double>(n) * scale));
+}
+
+// Worker threads per rank: `requested` (--threads) if positive, otherwise the hardware
+// threads split over the ranks sharing the node (MPI_COMM_TYPE_SHARED), so several ranks
+// per host do not oversubscribe the cores. Collective over MPI_COMM_WORLD.
+inline unsigned threads_per_rank(int requested)
+{
+    if (requested > 0) return static_cast<unsigned>(requested);
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    int local = 1;
+#ifdef MPI_VERSION
+    MPI_Comm node;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node);
+    MPI_Comm_size(node, &local);
+    MPI_Comm_free(&node);
+#endif
+    return std::max(1u, hw / static_cast<unsigned>(local));
+}
@@ -0,0 +1,157 @@
+// Time-budgeted in-situ triggering for the mini apps (--budget).
+//
+// Instead of a fixed output frequency the controller keeps the in-situ share of the wall
+// time near a target fraction b (e.g. 0.05). After every fired step it measures the
+// in-situ cost E of that step and the simulation time per step S since the previous fire
+// and picks the next interval n so that E / (E + n S) <= b:
+//
+//   n = ceil(E (1 - b) / (b S)),  clamped to [1, max_interval]
+//
+// E and S are smoothed (mean of the last value and the new one) and reduced with MAX over
+// ranks, because the slowest rank sets the pace of a collective pipeline. The reduction
+// happens only on fired steps, which all ranks agree on, so every rank computes the same
+// next step without communicating on the other steps.
+//
+// Must-fire steps (--must-fire, or must_fire() with the same steps on all ranks) always
+// fire. Rank 0 writes one CSV row per fired step to --trigger-log:
+//
+//   step,reason,insitu_s,sim_per_step_s,next_interval,insitu_fraction
+//
+// Without a budget every step fires and nothing is measured or communicated.
+//
+// The reductions run on the simulation thread while an async catalyst_execute may be in a
+// collective on MPI_COMM_WORLD, so the controller uses its own duplicate of it; free()
+// releases it (before MPI_Finalize).
+
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+class TriggerController
+{
+public:
+    TriggerController(double budget, const std::vector<int>& must_fire, const std::string& log_path,
+                      int max_interval = 1000)
+        : m_budget(budget), m_max_interval(std::max(1, max_interval)), m_must(must_fire.begin(), must_fire.end())
+    {
+#ifdef MPI_VERSION
+        MPI_Comm_rank(MPI_COMM_WORLD, &m_rank);
+        if (enabled()) MPI_Comm_dup(MPI_COMM_WORLD, &m_comm);
+#endif
+        if (enabled() && m_rank == 0 && !log_path.empty()) {
+            m_log.open(log_path);
+            if (m_log) {
+                m_log << "step,reason,insitu_s,sim_per_step_s,next_interval,insitu_fraction\n";
+            } else {
+                std::cerr << "TriggerController: cannot open " << log_path << " for writing\n";
+            }
+        }
+    }
+
+    TriggerController(const TriggerController&) = delete;
+    TriggerController& operator=(const TriggerController&) = delete;
+
+    bool enabled() const { return m_budget > 0.0; }
+
+    // Release the private communicator (collective; before MPI_Finalize).
+    void free()
+    {
+#ifdef MPI_VERSION
+        if (m_comm != MPI_COMM_NULL) MPI_Comm_free(&m_comm);
+#endif
+    }
+
+    // Add a must-fire step (the same on all ranks).
+    void must_fire(int step) { m_must.insert(step); }
+
+    // Fire at this step? Deterministic, so all ranks agree without communication.
+    bool fire(int step) const
+    {
+        return !enabled() || step >= m_next || m_must.count(step) > 0;
+    }
+
+    // Account a finished step: its wall time and the part spent in situ (0 if not fired).
+    // Collective on fired steps.
+    void end_step(int step, double step_seconds, double insitu_seconds)
+    {
+        if (!enabled()) return;
+        const bool fired = fire(step);
+        const bool must = m_must.count(step) > 0;
+        m_total += step_seconds;
+        m_insitu += insitu_seconds;
+        m_sim_since += std::max(0.0, step_seconds - insitu_seconds);
+        ++m_steps_since;
+        if (!fired) return;
+
+        double v[2] = {insitu_seconds, m_sim_since / m_steps_since};
+#ifdef MPI_VERSION
+        MPI_Allreduce(MPI_IN_PLACE, v, 2, MPI_DOUBLE, MPI_MAX, m_comm);
+#endif
+        m_cost = m_fires ? 0.5 * (m_cost + v[0]) : v[0];
+        m_sim_step = m_fires ? 0.5 * (m_sim_step + v[1]) : v[1];
+        ++m_fires;
+        if (must) ++m_must_fires;
+
+        int interval = m_max_interval;
+        if (m_sim_step > 0.0) {
+            const double n = std::ceil(m_cost * (1.0 - m_budget) / (m_budget * m_sim_step));
+            interval = static_cast<int>(std::clamp(n, 1.0, static_cast<double>(m_max_interval)));
+        }
+        // a must-fire step between regular fires does not restart the regular schedule
+        if (!must || step >= m_next) m_next = step + interval;
+        m_sim_since = 0.0;
+        m_steps_since = 0;
+
+        if (m_log) {
+            const char* reason = step == 0 ? "first" : (must ? "must" : "budget");
+            m_log << step << ',' << reason << ',' << v[0] << ',' << v[1] << ',' << interval << ','
+                  << (m_total > 0.0 ? m_insitu / m_total : 0.0) << '\n';
+        }
+    }
+
+    int fires() const { return m_fires; }
+
+    // Rank 0 prints the fires and the achieved in-situ share (max over ranks). Collective.
+    void report(const std::string& app, int steps) const
+    {
+        if (!enabled()) return;
+        double v[2] = {m_insitu, m_total};
+#ifdef MPI_VERSION
+        MPI_Allreduce(MPI_IN_PLACE, v, 2, MPI_DOUBLE, MPI_MAX, m_comm);
+#endif
+        if (m_rank == 0) {
+            std::cout << app << ": in-situ fired on " << m_fires << " of " << steps << " steps (" << m_must_fires
+                      << " must-fire), in-situ share " << 100.0 * (v[1] > 0.0 ? v[0] / v[1] : 0.0) << " % (budget "
+                      << 100.0 * m_budget << " %)\n";
+        }
+    }
+
+private:
+    double m_budget;
+    int m_max_interval;
+    std::set<int> m_must;
+    int m_rank = 0;
+    std::ofstream m_log;
+#ifdef MPI_VERSION
+    MPI_Comm m_comm = MPI_COMM_NULL;
+#endif
+
+    int m_next = 0;            // next regular fire
+    int m_fires = 0;
+    int m_must_fires = 0;
+    double m_cost = 0.0;       // smoothed in-situ cost per fire [s]
+    double m_sim_step = 0.0;   // smoothed simulation time per step [s]
+    double m_sim_since = 0.0;  // simulation time since the last fire
+    int m_steps_since = 0;
+    double m_total = 0.0;
+    double m_insitu = 0.0;
+};
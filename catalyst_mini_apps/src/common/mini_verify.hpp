@@ -0,0 +1,102 @@
+// Blueprint verification policy for the mini apps.
+//
+// conduit_cpp::Blueprint::verify walks and checks the whole mesh tree, which is wasted
+// work every step once the mesh layout is known to be valid. BlueprintVerifier verifies
+// fully on the first call and whenever the schema fingerprint changes; otherwise it only
+// recomputes the fingerprint (paths, dtypes, element counts and string values; no array
+// data is read).
+//
+// MINI_VERIFY=always (debug) forces a full verification on every call.
+
+#pragma once
+
+#include <catalyst.hpp>
+#include <catalyst_conduit_blueprint.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+class BlueprintVerifier
+{
+public:
+    enum class Mode { Once, Always };
+
+    explicit BlueprintVerifier(std::string protocol = "mesh", Mode mode = mode_from_env())
+        : m_protocol(std::move(protocol)), m_mode(mode)
+    {
+    }
+
+    static Mode mode_from_env()
+    {
+        const char* v = std::getenv("MINI_VERIFY");
+        return (v && std::string(v) == "always") ? Mode::Always : Mode::Once;
+    }
+
+    // True if `node` conforms to the protocol. `info` is only filled by a full verification.
+    bool check(const conduit_cpp::Node& node, conduit_cpp::Node& info)
+    {
+        const uint64_t fp = fingerprint(node);
+        if (m_mode == Mode::Once && m_verified && fp == m_fingerprint) {
+            m_last_full = false;
+            return true;
+        }
+        ++m_full;
+        m_last_full = true;
+        const bool ok = conduit_cpp::Blueprint::verify(m_protocol, node, info);
+        m_verified = ok;
+        m_fingerprint = fp;
+        return ok;
+    }
+
+    bool last_was_full() const { return m_last_full; }
+    std::size_t full_verifications() const { return m_full; }
+    Mode mode() const { return m_mode; }
+
+    // FNV-1a over the tree structure: child names, dtype ids, element counts, strings.
+    static uint64_t fingerprint(const conduit_cpp::Node& node)
+    {
+        uint64_t h = 14695981039346656037ull;
+        hash_node(conduit_cpp::c_node(&node), h);
+        return h;
+    }
+
+private:
+    static void mix(uint64_t& h, const void* p, std::size_t n)
+    {
+        const auto* b = static_cast<const unsigned char*>(p);
+        for (std::size_t i = 0; i < n; ++i) {
+            h ^= b[i];
+            h *= 1099511628211ull;
+        }
+    }
+
+    static void hash_node(conduit_node* cnode, uint64_t& h)
+    {
+        conduit_cpp::Node node = conduit_cpp::cpp_node(cnode);  // non-owning handle
+        const int64_t id = static_cast<int64_t>(node.dtype().id());
+        const int64_t nelem = static_cast<int64_t>(node.dtype().number_of_elements());
+        mix(h, &id, sizeof(id));
+        mix(h, &nelem, sizeof(nelem));
+        if (id == CONDUIT_CHAR8_STR_ID) {
+            const std::string s = conduit_node_as_char8_str(cnode);
+            mix(h, s.data(), s.size());
+        }
+        const auto nchild = node.number_of_children();
+        for (conduit_index_t i = 0; i < nchild; ++i) {
+            conduit_cpp::Node c = node.child(i);
+            const std::string name = c.name();
+            mix(h, name.data(), name.size() + 1);  // include the terminator: "ab"+"c" != "a"+"bc"
+            hash_node(conduit_cpp::c_node(&c), h);
+        }
+        const char end = '/';
+        mix(h, &end, 1);
+    }
+
+    std::string m_protocol;
+    Mode m_mode;
+    bool m_verified = false;
+    bool m_last_full = false;
+    uint64_t m_fingerprint = 0;
+    std::size_t m_full = 0;
+};
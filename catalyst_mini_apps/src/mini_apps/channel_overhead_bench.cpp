@@ -0,0 +1,115 @@
+// Per-step adaptor overhead: rebuilding the Conduit exec tree vs reusing a persistent one.
+//
+// For 1..100 element fields on a small uniform mesh, each mode publishes `steps` steps
+// without calling catalyst_execute (only the simulation-side node work is timed):
+// - rebuild/copy:     new exec node per step, all paths set by string, field values copied
+//                     with set_int32_ptr (what the mini apps used to do)
+// - rebuild/external: same tree rebuild, field values referenced with set_external
+// - reuse:            PersistentChannel built once; per step set_state + set_field
+//
+// Usage: ./build/channel_overhead_bench [cells_per_field=4096] [steps=200]
+
+#include <catalyst.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/mini_channel.hpp"
+
+using clk = std::chrono::steady_clock;
+
+static void build_uniform_mesh(conduit_cpp::Node data, int n)
+{
+    data["coordsets/coords/type"].set("uniform");
+    data["coordsets/coords/dims/i"].set(n + 1);
+    data["coordsets/coords/dims/j"].set(n + 1);
+    data["coordsets/coords/dims/k"].set(n + 1);
+    data["coordsets/coords/origin/x"].set(0.0);
+    data["coordsets/coords/origin/y"].set(0.0);
+    data["coordsets/coords/origin/z"].set(0.0);
+    data["coordsets/coords/spacing/dx"].set(1.0);
+    data["coordsets/coords/spacing/dy"].set(1.0);
+    data["coordsets/coords/spacing/dz"].set(1.0);
+    data["topologies/topo/type"].set("uniform");
+    data["topologies/topo/coordset"].set("coords");
+}
+
+static double rebuild_us(std::vector<std::vector<int32_t>>& fields, int n, int steps, bool external)
+{
+    const int64_t ncell = static_cast<int64_t>(fields[0].size());
+    auto t0 = clk::now();
+    for (int step = 0; step < steps; ++step) {
+        conduit_cpp::Node exec;
+        exec["catalyst/state/cycle"].set(step);
+        exec["catalyst/state/time"].set(static_cast<double>(step));
+        exec["catalyst/state/domain_id"].set(0);
+        conduit_cpp::Node ch = exec["catalyst/channels/uniform"];
+        ch["type"].set("mesh");
+        conduit_cpp::Node data = ch["data"];
+        build_uniform_mesh(data, n);
+        for (std::size_t f = 0; f < fields.size(); ++f) {
+            const std::string base = "fields/f" + std::to_string(f);
+            if (external) {
+                set_external_values(data[base + "/values"], fields[f].data(), ncell);
+            } else {
+                data[base + "/values"].set_int32_ptr(fields[f].data(), ncell);
+            }
+            data[base + "/association"].set("element");
+            data[base + "/topology"].set("topo");
+        }
+    }
+    return std::chrono::duration<double, std::micro>(clk::now() - t0).count() / steps;
+}
+
+static double reuse_us(std::vector<std::vector<int32_t>>& fields, int n, int steps)
+{
+    const int64_t ncell = static_cast<int64_t>(fields[0].size());
+    PersistentChannel channel("uniform");
+    build_uniform_mesh(channel.data(), n);
+    for (std::size_t f = 0; f < fields.size(); ++f) {
+        channel.add_field("f" + std::to_string(f), "element", "topo", fields[f].data(), ncell);
+    }
+
+    auto t0 = clk::now();
+    for (int step = 0; step < steps; ++step) {
+        channel.set_state(step, static_cast<double>(step), 0);
+        for (std::size_t f = 0; f < fields.size(); ++f) channel.set_field(f, fields[f].data(), ncell);
+    }
+    return std::chrono::duration<double, std::micro>(clk::now() - t0).count() / steps;
+}
+
+int main(int argc, char** argv)
+{
+    const int64_t cells = argc > 1 ? std::atoll(argv[1]) : 4096;
+    const int steps = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (cells <= 0 || steps <= 0) {
+        std::cerr << "channel_overhead_bench: cells_per_field and steps must be positive\n"
+                  << "usage: " << argv[0] << " [cells_per_field=4096] [steps=200]\n";
+        return 1;
+    }
+
+    // cube of n^3 >= cells elements
+    int n = 1;
+    while (static_cast<int64_t>(n) * n * n < cells) ++n;
+    const int64_t ncell = static_cast<int64_t>(n) * n * n;
+
+    std::cout << "cells per field: " << ncell << " (" << n << "^3), steps: " << steps << "\n";
+    std::cout << std::setw(8) << "fields" << std::setw(20) << "rebuild/copy [us]" << std::setw(24)
+              << "rebuild/external [us]" << std::setw(14) << "reuse [us]" << std::setw(12) << "speedup" << "\n";
+
+    for (int nf : {1, 2, 5, 10, 20, 50, 100}) {
+        std::vector<std::vector<int32_t>> fields(static_cast<std::size_t>(nf),
+                                                 std::vector<int32_t>(static_cast<std::size_t>(ncell), 1));
+        const double copy = rebuild_us(fields, n, steps, false);
+        const double ext = rebuild_us(fields, n, steps, true);
+        const double reuse = reuse_us(fields, n, steps);
+        std::cout << std::setw(8) << nf << std::fixed << std::setprecision(2) << std::setw(20) << copy
+                  << std::setw(24) << ext << std::setw(14) << reuse << std::setw(11) << copy / reuse << "x\n";
+    }
+    return 0;
+}
@@ -1,5 +1,20 @@
 // Explicit-coordinate 3D mesh mini app using Catalyst 2.0 (multi-rank ready)
 // Mirrors uniform_mini.cpp but builds an explicit coordset + unstructured hex topology.
+// --mesh selects the representation of the (logically structured) grid:
+//   unstructured  explicit x/y/z per point + 8 connectivity entries per hex (default)
+//   mixed         as unstructured, but a Blueprint "mixed" topology of hexes, wedges and tets
+//   rectilinear   one coordinate array per axis, implicit topology
+//   structured    explicit x/y/z per point, implicit topology (no connectivity)
+// Connectivity uses 32-bit indices whenever the local block allows it (--index overrides).
+// Rank 0 reports the mesh memory and the mean catalyst_execute time of the mode.
+// The geometry is published as static (version-tagged), so only the fields change per step.
+// The exec tree is built once; coordinates, connectivity and the field are referenced
+// zero-copy, so a step only updates the state scalars and the field pointer.
+// Mesh size, steps and field count come from the command line / environment
+// (common/mini_config.hpp); the grid is block-decomposed in 3D over any rank count.
+// --work runs a synthetic compute kernel per step, --csv writes per-phase timings.
+// --async runs catalyst_execute on a separate thread on double-buffered field copies.
+// --budget F runs in situ only as often as keeps its share of the wall time near F.
 
 #include <catalyst.hpp>
 
@@ -7,10 +22,21 @@
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "common/mini_async.hpp"
+#include "common/mini_bench.hpp"
+#include "common/mini_channel.hpp"
+#include "common/mini_config.hpp"
+#include "common/mini_connectivity.hpp"
+#include "common/mini_decomp.hpp"
+#include "common/mini_trigger.hpp"
+#include "common/mini_verify.hpp"
+
 #include <mpi.h>
 #ifdef MPI_VERSION
 #  define MINI_HAVE_MPI 1
@@ -33,33 +59,61 @@ static inline int64_t vtx_index(int i, int j, int k, int nx, int ny)
 
 
 
-static void build_explicit3d_hex_mesh(conduit_cpp::Node data,
-                                      int nx, int ny, int nz,
-                                      std::vector<double>& xs,
-                                      std::vector<double>& ys,
-                                      std::vector<double>& zs,
-                                      std::vector<int64_t>& conn,
-                                      const int32_t* vals_ptr, int64_t ncell)
+static void build_rectilinear3d_mesh(conduit_cpp::Node data,
+                                     std::vector<double>& xs,
+                                     std::vector<double>& ys,
+                                     std::vector<double>& zs)
+{
+  // One coordinate array per axis; the topology is implied by the coordset
+  data["coordsets/coords/type"].set("rectilinear");
+  set_external_values(data["coordsets/coords/values/x"], xs.data(), static_cast<int64_t>(xs.size()));
+  set_external_values(data["coordsets/coords/values/y"], ys.data(), static_cast<int64_t>(ys.size()));
+  set_external_values(data["coordsets/coords/values/z"], zs.data(), static_cast<int64_t>(zs.size()));
+
+  data["topologies/topo/type"].set("rectilinear");
+  data["topologies/topo/coordset"].set("coords");
+}
+
+static void build_structured3d_mesh(conduit_cpp::Node data,
+                                    int nx, int ny, int nz,
+                                    std::vector<double>& xs,
+                                    std::vector<double>& ys,
+                                    std::vector<double>& zs)
+{
+  // Explicit points, implicit (i,j,k) topology: no connectivity array
+  const int64_t np = static_cast<int64_t>(nx) * ny * nz;
+  data["coordsets/coords/type"].set("explicit");
+  set_external_values(data["coordsets/coords/values/x"], xs.data(), np);
+  set_external_values(data["coordsets/coords/values/y"], ys.data(), np);
+  set_external_values(data["coordsets/coords/values/z"], zs.data(), np);
+
+  conduit_cpp::Node topo = data["topologies/topo"];
+  topo["type"].set("structured");
+  topo["coordset"].set("coords");
+  topo["elements/dims/i"].set(nx - 1);
+  topo["elements/dims/j"].set(ny - 1);
+  topo["elements/dims/k"].set(nz - 1);
+}
+
+template <typename Index>
+static void build_explicit3d_unstructured_mesh(conduit_cpp::Node data,
+                                               int nx, int ny, int nz,
+                                               std::vector<double>& xs,
+                                               std::vector<double>& ys,
+                                               std::vector<double>& zs,
+                                               const CellConnectivity<Index>& conn)
 {
   // Points (explicit) and topology pointers
   const int64_t np = static_cast<int64_t>(nx) * ny * nz;
   data["coordsets/coords/type"].set("explicit");
-  data["coordsets/coords/values/x"].set_float64_ptr(xs.data(), np);
-  data["coordsets/coords/values/y"].set_float64_ptr(ys.data(), np);
-  data["coordsets/coords/values/z"].set_float64_ptr(zs.data(), np);
+  set_external_values(data["coordsets/coords/values/x"], xs.data(), np);
+  set_external_values(data["coordsets/coords/values/y"], ys.data(), np);
+  set_external_values(data["coordsets/coords/values/z"], zs.data(), np);
 
   conduit_cpp::Node topo = data["topologies/topo"];
   topo["type"].set("unstructured");
   topo["coordset"].set("coords");
-  // Conduit blueprint expects singular shape names: "hex"
-  topo["elements/shape"].set("hex");
-  topo["elements/connectivity"].set_int64_ptr(conn.data(), static_cast<int64_t>(conn.size()));
-
-  // Field on elements
-  conduit_cpp::Node fld = data["fields/f/values"];
-  fld.set_int32_ptr(const_cast<int32_t*>(vals_ptr), ncell);
-  data["fields/f/association"].set("element");
-  data["fields/f/topology"].set("topo");
+  conn.publish(topo);
 }
 
 
@@ -79,14 +133,74 @@ int main(int argc, char** argv)
 {
 
 
+    /* CONFIGURATION (read first: the MPI thread level depends on --async) */
+  MiniConfig cfg;
+  std::string cfg_error;
+  try {
+    cfg = MiniConfig::parse(argc, argv);
+  } catch (const std::exception& e) {
+    cfg_error = e.what();
+  }
+  AsyncPolicy async = cfg_error.empty() ? parse_async_policy(cfg.async) : AsyncPolicy::Off;
+
     /* MPI SETUP */
   int rank = 0, size = 1;
 #if MINI_HAVE_MPI
-  MPI_Init(&argc, &argv);
+  const int provided = mini_mpi_init(&argc, &argv, async != AsyncPolicy::Off);
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (async != AsyncPolicy::Off && provided < MPI_THREAD_MULTIPLE) {
+    if (rank == 0) std::cerr << "explicit_mini: MPI_THREAD_MULTIPLE not available, running in-situ synchronously\n";
+    async = AsyncPolicy::Off;
+  }
 #endif
 
+    /* DECOMPOSITION */
+  auto fail = [&](const std::string& msg) {
+    if (rank == 0) {
+      std::cerr << msg << "\n";
+      MiniConfig::usage(std::cerr, argv[0]);
+    }
+#if MINI_HAVE_MPI
+    MPI_Finalize();
+#endif
+    return 1;
+  };
+  if (!cfg_error.empty()) return fail(cfg_error);
+  CartDecomp decomp;
+  try {
+#if MINI_HAVE_MPI
+    decomp = cfg.cells_per_rank ? CartDecomp::create_weak(MPI_COMM_WORLD, cfg.cells)
+                                : CartDecomp::create(MPI_COMM_WORLD, cfg.cells);
+#else
+    decomp = CartDecomp::serial(cfg.cells);
+#endif
+  } catch (const std::exception& e) {
+    return fail(e.what());
+  }
+  if (cfg.help) {
+    if (rank == 0) MiniConfig::usage(std::cout, argv[0]);
+#if MINI_HAVE_MPI
+    MPI_Finalize();
+#endif
+    return 0;
+  }
+  const bool rectilinear = cfg.mesh == "rectilinear";
+  const bool mixed = cfg.mesh == "mixed";
+  const bool unstructured = cfg.mesh == "unstructured" || mixed;
+  if (unstructured && cfg.index_bits == 32) {
+    // forced 32-bit ids must hold every point id and offset on every rank, else they would wrap
+    int fits = index_fits_int32(decomp.local_points(), mixed ? decomp.local_cells() * 24 : 0) ? 1 : 0;
+#if MINI_HAVE_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &fits, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+    if (!fits) return fail("--index 32: the local point count or connectivity exceeds 32-bit indices, use --index 64");
+  }
+  if (rank == 0) {
+    std::cout << "explicit_mini: " << cfg << " mesh=" << cfg.mesh << " ranks=" << size << " (" << decomp.dims[0] << "x" << decomp.dims[1]
+              << "x" << decomp.dims[2] << ")\n";
+  }
+
   conduit_cpp::Node init;
 #if MINI_HAVE_MPI
   const int fcomm = MPI_Comm_c2f(MPI_COMM_WORLD);
@@ -114,87 +228,222 @@ int main(int argc, char** argv)
 #endif
   }
 
-  // Simulation parameters: 4 elements per dimension globally
-  const int steps = 20;
-  const int pts_total = 5;
-  const int nx = (size == 2 ? 3 : pts_total);
-  const int ny = pts_total;
-  const int nz = pts_total;
+  // Simulation parameters: local block of the global grid (neighbours share a point plane)
+  const int steps = cfg.steps;
+  const int nx = static_cast<int>(decomp.points(0));
+  const int ny = static_cast<int>(decomp.points(1));
+  const int nz = static_cast<int>(decomp.points(2));
   const double dx = 1.0, dy = 1.0, dz = 1.0;
   const double ox0 = 0.0, oy0 = 0.0, oz0 = 0.0;
 
-  const int ex = nx - 1, ey = ny - 1, ez = nz - 1;
-  const int64_t ncell = static_cast<int64_t>(ex) * ey * ez;
-  std::vector<int32_t> vals(static_cast<size_t>(ncell));
+  const int64_t ncell = decomp.local_cells();
 
   // Allocate coordinates and connectivity once; coordinates are static per-rank
+  // (rectilinear: one array per axis; connectivity only for the unstructured modes)
   const int64_t np = static_cast<int64_t>(nx) * ny * nz;
-  std::vector<double> xs(static_cast<size_t>(np));
-  std::vector<double> ys(static_cast<size_t>(np));
-  std::vector<double> zs(static_cast<size_t>(np));
-  std::vector<int64_t> conn(static_cast<size_t>(ncell) * 8);
+  std::vector<double> xs(static_cast<size_t>(rectilinear ? nx : np));
+  std::vector<double> ys(static_cast<size_t>(rectilinear ? ny : np));
+  std::vector<double> zs(static_cast<size_t>(rectilinear ? nz : np));
+
+  // Index width: 32 bit if every point id (and, for mixed, every offset: at most 24
+  // entries per cell) fits, unless --index forces one
+  const bool idx32 = cfg.index_bits == 32 ||
+                     (cfg.index_bits == 0 && index_fits_int32(np, mixed ? ncell * 24 : 0));
+  CellConnectivity<int32_t> conn32;
+  CellConnectivity<int64_t> conn64;
+  if (unstructured) {
+    if (idx32) {
+      conn32 = mixed ? mixed_connectivity<int32_t>(nx, ny, nz) : hex_connectivity<int32_t>(nx, ny, nz);
+    } else {
+      conn64 = mixed ? mixed_connectivity<int64_t>(nx, ny, nz) : hex_connectivity<int64_t>(nx, ny, nz);
+    }
+  }
+  const std::vector<int64_t>& element_cell = idx32 ? conn32.element_cell : conn64.element_cell;
+  const int64_t nelem = !mixed ? ncell : (idx32 ? conn32.num_elements() : conn64.num_elements());
+
+  // Field values per cell; mixed topologies expand them to their elements every step
+  std::vector<std::vector<int32_t>> vals(static_cast<size_t>(cfg.fields), std::vector<int32_t>(static_cast<size_t>(nelem)));
+  std::vector<int32_t> cell_vals(mixed ? static_cast<size_t>(ncell) : 0);
 
 
 
   // Fill coordinates once (local domain)
-  const double ox = ox0 + rank * (nx - 1) * dx;
-  for (int k = 0; k < nz; ++k)
-    for (int j = 0; j < ny; ++j)
-      for (int i = 0; i < nx; ++i) {
-        const int64_t id = vtx_index(i, j, k, nx, ny);
-        xs[static_cast<size_t>(id)] = ox + i * dx;
-        ys[static_cast<size_t>(id)] = oy0 + j * dy;
-        zs[static_cast<size_t>(id)] = oz0 + k * dz;
-      }
-  {
-    // Fill connectivity once (local domain)
-    size_t c = 0;
-    for (int k = 0; k < ez; ++k)
-      for (int j = 0; j < ey; ++j)
-        for (int i = 0; i < ex; ++i) {
-          const int64_t v0 = vtx_index(i,   j,   k,   nx, ny);
-          const int64_t v1 = vtx_index(i+1, j,   k,   nx, ny);
-          const int64_t v2 = vtx_index(i+1, j+1, k,   nx, ny);
-          const int64_t v3 = vtx_index(i,   j+1, k,   nx, ny);
-          const int64_t v4 = vtx_index(i,   j,   k+1, nx, ny);
-          const int64_t v5 = vtx_index(i+1, j,   k+1, nx, ny);
-          const int64_t v6 = vtx_index(i+1, j+1, k+1, nx, ny);
-          const int64_t v7 = vtx_index(i,   j+1, k+1, nx, ny);
-          conn[c++] = v0; conn[c++] = v1; conn[c++] = v2; conn[c++] = v3;
-          conn[c++] = v4; conn[c++] = v5; conn[c++] = v6; conn[c++] = v7;
+  const double ox = ox0 + static_cast<double>(decomp.cell_begin[0]) * dx;
+  const double oy = oy0 + static_cast<double>(decomp.cell_begin[1]) * dy;
+  const double oz = oz0 + static_cast<double>(decomp.cell_begin[2]) * dz;
+  if (rectilinear) {
+    for (int i = 0; i < nx; ++i) xs[static_cast<size_t>(i)] = ox + i * dx;
+    for (int j = 0; j < ny; ++j) ys[static_cast<size_t>(j)] = oy + j * dy;
+    for (int k = 0; k < nz; ++k) zs[static_cast<size_t>(k)] = oz + k * dz;
+  } else {
+    for (int k = 0; k < nz; ++k)
+      for (int j = 0; j < ny; ++j)
+        for (int i = 0; i < nx; ++i) {
+          const int64_t id = vtx_index(i, j, k, nx, ny);
+          xs[static_cast<size_t>(id)] = ox + i * dx;
+          ys[static_cast<size_t>(id)] = oy + j * dy;
+          zs[static_cast<size_t>(id)] = oz + k * dz;
         }
   }
 
 
+  // The geometry never moves: publish it under a content version; bump the version
+  // whenever xs/ys/zs/conn change (remeshing) and it is rebuilt on the next step
+  const std::vector<std::string> geometry_paths = {"coordsets/coords", "topologies/topo"};
+  const int64_t geometry_version = 1;
+  auto build_geometry = [&](conduit_cpp::Node data) {
+    if (rectilinear) {
+      build_rectilinear3d_mesh(data, xs, ys, zs);
+    } else if (unstructured && idx32) {
+      build_explicit3d_unstructured_mesh(data, nx, ny, nz, xs, ys, zs, conn32);
+    } else if (unstructured) {
+      build_explicit3d_unstructured_mesh(data, nx, ny, nz, xs, ys, zs, conn64);
+    } else {
+      build_structured3d_mesh(data, nx, ny, nz, xs, ys, zs);
+    }
+  };
+  const double mesh_bytes = static_cast<double>((xs.size() + ys.size() + zs.size()) * sizeof(double) +
+                                                conn32.bytes() + conn64.bytes());
+
+  // Channel built once: mesh arrays and fields (`fv`) are external, the tree is reused every step
+  auto make_channel = [&](std::vector<std::vector<int32_t>>& fv) {
+    auto channel = std::make_unique<PersistentChannel>("explicit");
+    // channel->exec()["catalyst/channels/explicit/state/multiblock"].set(1); // let PV treat ranks as partitions (required for live viz multi-rank)
+    channel->publish_static(geometry_paths, geometry_version, build_geometry);
+    for (int f = 0; f < cfg.fields; ++f) {
+      const std::string name = f == 0 ? "f" : "f" + std::to_string(f);
+      channel->add_field(name, "element", "topo", fv[static_cast<size_t>(f)].data(), nelem);
+    }
+    return channel;
+  };
+
+  // Synchronous: one channel on the simulation's arrays. Async: one channel per buffer
+  // slot (sharing the geometry arrays), executed by the in-situ thread
+  std::vector<std::vector<std::vector<int32_t>>> slot_vals;
+  std::vector<std::unique_ptr<PersistentChannel>> channels;
+  std::unique_ptr<AsyncInSitu> insitu;
+  if (async == AsyncPolicy::Off) {
+    channels.push_back(make_channel(vals));
+  } else {
+    slot_vals.assign(2, vals);
+    for (auto& fv : slot_vals) channels.push_back(make_channel(fv));
+    insitu = std::make_unique<AsyncInSitu>(2, async, [&channels](int slot) {
+      return catalyst_execute(channels[static_cast<size_t>(slot)]->c_exec()) == catalyst_status_ok;
+    });
+  }
+  BlueprintVerifier verifier("mesh");  // verify once / on schema change (MINI_VERIFY=always: every step)
+
+
+  PhaseLog phases(steps);
+  std::optional<SyntheticKernel> kernel;
+  if (cfg.work > 0) kernel.emplace(decomp);
+  TriggerController trigger(cfg.budget, cfg.must_fire, cfg.trigger_log);
+
+
   /* "SIMULATION" */
+  const auto t_loop = PhaseLog::now();
   for (int step = 0; step < steps; ++step) {
-    conduit_cpp::Node exec;
-    exec["catalyst/state/cycle"].set(step);
-    exec["catalyst/state/time"].set(static_cast<double>(step));
-    exec["catalyst/state/domain_id"].set(rank);
+    const auto t_step = PhaseLog::now();
 
-    conduit_cpp::Node ch = exec["catalyst/channels/explicit"];
-    ch["type"].set("mesh");
-    // ch["state/multiblock"].set(1); // let PV treat ranks as partitions (required for live viz multi-rank)
+    auto t0 = PhaseLog::now();
+    if (kernel) kernel->run(cfg.work);
+    phases.add(step, Phase::Compute, PhaseLog::since(t0));
 
     // Update field values
-    if ((step % 2) == 0) {
-      for (int64_t i = 0; i < ncell; ++i) vals[static_cast<size_t>(i)] = static_cast<int32_t>(i + step);
-    } else {
-      for (int64_t i = 0; i < ncell; ++i) vals[static_cast<size_t>(i)] = static_cast<int32_t>((ncell - 1 - i) + step);
+    t0 = PhaseLog::now();
+    for (int f = 0; f < cfg.fields; ++f) {
+      if (mixed) {
+        fill_cell_values(cell_vals, decomp, step, f);
+        expand_to_elements(cell_vals, element_cell, vals[static_cast<size_t>(f)]);
+      } else {
+        fill_cell_values(vals[static_cast<size_t>(f)], decomp, step, f);
+      }
     }
+    phases.add(step, Phase::FieldUpdate, PhaseLog::since(t0));
+
+    // In situ this step? (trigger: same answer on all ranks); async: claim a buffer slot
+    // (blocks, or -1 when the frame is dropped on all ranks)
+    t0 = PhaseLog::now();
+    const int slot = !trigger.fire(step) ? -1 : (insitu ? insitu->acquire() : 0);
+    const double t_acquire = PhaseLog::since(t0);
+    if (slot < 0) {
+      phases.add(step, Phase::Execute, t_acquire);
+      if (cfg.sleep > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(cfg.sleep));
+      const double t = PhaseLog::since(t_step);
+      phases.add(step, Phase::Step, t);
+      trigger.end_step(step, t, t_acquire);
+      continue;
+    }
+    PersistentChannel& channel = *channels[static_cast<size_t>(slot)];
 
-  build_explicit3d_hex_mesh(ch["data"], nx, ny, nz,
-                xs, ys, zs, conn, vals.data(), ncell);
+    t0 = PhaseLog::now();
+    auto& fv = insitu ? slot_vals[static_cast<size_t>(slot)] : vals;
+    if (insitu) {
+      for (int f = 0; f < cfg.fields; ++f) fv[static_cast<size_t>(f)] = vals[static_cast<size_t>(f)];
+    }
+    channel.set_state(step, static_cast<double>(step), rank);
+    channel.publish_static(geometry_paths, geometry_version, build_geometry);  // no-op while unchanged
+    for (int f = 0; f < cfg.fields; ++f) {
+      channel.set_field(static_cast<std::size_t>(f), fv[static_cast<size_t>(f)].data(), nelem);
+    }
+    phases.add(step, Phase::NodeBuild, PhaseLog::since(t0));
+
+    t0 = PhaseLog::now();
+    conduit_cpp::Node verify_info;
+    const bool is_valid = verifier.check(channel.data(), verify_info);
+    phases.add(step, Phase::Verify, PhaseLog::since(t0));
+    if (!is_valid) {
+      std::cerr << "[Rank " << rank << "] Mesh blueprint verification FAILED at step " << step << ":\n";
+      verify_info.print();
+#if MINI_HAVE_MPI
+      MPI_Abort(MPI_COMM_WORLD, 3);
+#else
+      return 3;
+#endif
+    }
 
     /* CATALYST EXECUTE */
-    ierr = catalyst_execute(conduit_cpp::c_node(&exec));
+    // Execute, or hand the slot to the in-situ thread (Execute: time the simulation stalls)
+    t0 = PhaseLog::now();
+    if (insitu) {
+      insitu->publish(slot);
+      ierr = insitu->failures() ? catalyst_status_error_incomplete : catalyst_status_ok;
+    } else {
+      ierr = catalyst_execute(channel.c_exec());
+    }
+    phases.add(step, Phase::Execute, t_acquire + PhaseLog::since(t0));
     if (ierr != catalyst_status_ok) {
       std::cerr << "catalyst_execute failed (step=" << step << ") code " << static_cast<int>(ierr) << "\n";
       break;
     }
 
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    if (cfg.sleep > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(cfg.sleep));
+    const double t = PhaseLog::since(t_step);
+    phases.add(step, Phase::Step, t);
+    trigger.end_step(step, t, phases.get(step, Phase::NodeBuild) + phases.get(step, Phase::Verify) +
+                                  phases.get(step, Phase::Execute));
+  }
+
+  const double loop_wall = PhaseLog::since(t_loop);
+  const auto t_drain = PhaseLog::now();
+  if (insitu) insitu->finish();
+  report_throughput("explicit_mini", steps, loop_wall, PhaseLog::since(t_drain), insitu.get());
+  trigger.report("explicit_mini", steps);
+  if (kernel) kernel->report("explicit_mini");
+
+  if (cfg.bench()) phases.write_csv(cfg.csv, "explicit_mini/" + cfg.mesh, cfg, decomp);
+
+  // Mesh footprint (sum over ranks) and execute cost (slowest rank) of this mesh mode
+  double mesh_total = mesh_bytes, exec_max = phases.mean(Phase::Execute);
+#if MINI_HAVE_MPI
+  const double exec_local = exec_max;
+  MPI_Reduce(&mesh_bytes, &mesh_total, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&exec_local, &exec_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+#endif
+  if (rank == 0) {
+    std::cout << "explicit_mini [" << cfg.mesh << (unstructured ? (idx32 ? ", int32" : ", int64") : "")
+              << "]: mesh memory " << mesh_total / (1024.0 * 1024.0)
+              << " MiB (all ranks), catalyst_execute " << 1e3 * exec_max << " ms per step (max over ranks)\n";
   }
 
   conduit_cpp::Node fin;
@@ -203,7 +452,9 @@ int main(int argc, char** argv)
     std::cerr << "catalyst_finalize failed with code " << static_cast<int>(ierr) << "\n";
   }
 
+  trigger.free();
 #if MINI_HAVE_MPI
+  decomp.free();
   MPI_Finalize();
 #endif
 
@@ -0,0 +1,327 @@
+// Particle mini app: SoA particles published as a Blueprint point cloud (multi-rank).
+// - Each rank owns the box of its CartDecomp block (one unit per cell, --cells) and
+//   advances --particles N particles on average; counts vary linearly over the ranks
+//   (--imbalance), so the in-situ cost can be measured against the particle count
+// - Particles live in an APL ParticleSoA (apl/src_dynamic/particles_soa.h): position,
+//   velocity (3 components), energy and a global id, every component a dense array
+// - Pusher: rotation in a uniform magnetic field along z plus a harmonic well in z,
+//   reflecting walls at the rank box (no migration); multithreaded over particle chunks
+// - Channel "particles": coordset explicit x/y/z, topology unstructured with
+//   elements/shape "point", one vertex field per attribute; all arrays zero-copy
+//   (ConduitPointMesh in conduit_bridge.h)
+// - --keep N publishes only N particles in total (apl decimate.h): each rank gets a share
+//   proportional to its particle count and picks it by --sample stride, reservoir or
+//   importance (weighted by energy) into a reused SoA copy; the full set stays untouched
+// - Same per-phase timing as the mesh apps (--csv): compute = push, field_update =
+//   attribute update, node_build = decimation + publish, verify, execute
+
+#include <catalyst.hpp>
+#include <catalyst_conduit_blueprint.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/mini_bench.hpp"
+#include "common/mini_channel.hpp"
+#include "common/mini_config.hpp"
+#include "common/mini_decomp.hpp"
+#include "common/mini_verify.hpp"
+
+#include <mpi.h>
+#ifdef MPI_VERSION
+#  define MINI_HAVE_MPI 1
+#  define APL_HAVE_MPI 1   // rank_budget over MPI_COMM_WORLD
+#else
+#  define MINI_HAVE_MPI 0
+#endif
+
+#include "bpl.h"
+#include "conduit_bridge.h"
+
+using Particles = ParticleSoA<double, 3>;
+
+static std::string get_env_or(const char* key, const std::string& defval)
+{
+    const char* v = std::getenv(key);
+    return v ? std::string(v) : defval;
+}
+
+struct Box
+{
+    double lo[3], hi[3];
+};
+
+// Uniform positions in the box, thermal velocities, ids first_id, first_id + 1, ...
+static void init_particles(Particles& p, const Box& box, int64_t first_id, uint64_t seed)
+{
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::normal_distribution<double> g(0.0, 0.5);
+    const std::size_t vel = p.find("velocity"), id = p.find("id");
+    for (std::size_t i = 0; i < p.size(); ++i) {
+        for (unsigned a = 0; a < 3; ++a) {
+            p.pos(a)[i] = box.lo[a] + u(gen) * (box.hi[a] - box.lo[a]);
+            p.data<double>(vel, a)[i] = g(gen);
+        }
+        p.data<int64_t>(id)[i] = first_id + static_cast<int64_t>(i);
+    }
+}
+
+// One step: rotate v about z by omega*dt, harmonic acceleration towards the box centre in z,
+// drift, reflect at the box walls.
+static void push(Particles& p, const Box& box, double dt, unsigned nthreads)
+{
+    const std::size_t vel = p.find("velocity");
+    double* x = p.pos(0);
+    double* y = p.pos(1);
+    double* z = p.pos(2);
+    double* vx = p.data<double>(vel, 0);
+    double* vy = p.data<double>(vel, 1);
+    double* vz = p.data<double>(vel, 2);
+    const double omega = 2.0, k = 1.0;
+    const double c = std::cos(omega * dt), s = std::sin(omega * dt);
+    const double zc = 0.5 * (box.lo[2] + box.hi[2]);
+
+    parallel_for_chunks(p.size(), nthreads, [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t i = b; i < e; ++i) {
+            const double ux = vx[i] * c + vy[i] * s;
+            const double uy = -vx[i] * s + vy[i] * c;
+            vx[i] = ux;
+            vy[i] = uy;
+            vz[i] -= k * (z[i] - zc) * dt;
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            z[i] += vz[i] * dt;
+        }
+        double* q[3] = {x, y, z};
+        double* v[3] = {vx, vy, vz};
+        for (unsigned a = 0; a < 3; ++a) {
+            const double lo = box.lo[a], hi = box.hi[a];
+            for (std::size_t i = b; i < e; ++i) {
+                if (q[a][i] < lo) { q[a][i] = 2.0 * lo - q[a][i]; v[a][i] = -v[a][i]; }
+                if (q[a][i] > hi) { q[a][i] = 2.0 * hi - q[a][i]; v[a][i] = -v[a][i]; }
+            }
+        }
+    });
+}
+
+// Kinetic energy per particle (unit mass).
+static void update_energy(Particles& p, unsigned nthreads)
+{
+    const std::size_t vel = p.find("velocity");
+    const double* vx = p.data<double>(vel, 0);
+    const double* vy = p.data<double>(vel, 1);
+    const double* vz = p.data<double>(vel, 2);
+    double* en = p.data<double>(p.find("energy"));
+    parallel_for_chunks(p.size(), nthreads, [&](std::size_t b, std::size_t e, unsigned) {
+        for (std::size_t i = b; i < e; ++i) en[i] = 0.5 * (vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]);
+    });
+}
+
+int main(int argc, char** argv)
+{
+    // --- MPI init ---
+    int rank = 0, size = 1;
+#if MINI_HAVE_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+    // --- Configuration and decomposition ---
+    auto fail = [&](const std::string& msg) {
+        if (rank == 0) {
+            std::cerr << msg << "\n";
+            MiniConfig::usage(std::cerr, argv[0]);
+        }
+#if MINI_HAVE_MPI
+        MPI_Finalize();
+#endif
+        return 1;
+    };
+    MiniConfig cfg;
+    CartDecomp decomp;
+    try {
+        cfg = MiniConfig::parse(argc, argv);
+#if MINI_HAVE_MPI
+        decomp = cfg.cells_per_rank ? CartDecomp::create_weak(MPI_COMM_WORLD, cfg.cells)
+                                    : CartDecomp::create(MPI_COMM_WORLD, cfg.cells);
+#else
+        decomp = CartDecomp::serial(cfg.cells);
+#endif
+    } catch (const std::exception& e) {
+        return fail(e.what());
+    }
+    if (cfg.help) {
+        if (rank == 0) MiniConfig::usage(std::cout, argv[0]);
+#if MINI_HAVE_MPI
+        MPI_Finalize();
+#endif
+        return 0;
+    }
+
+    // --- Particles of this rank ---
+    const int64_t nlocal = particles_of_rank(cfg.particles, cfg.imbalance, rank, size);
+    int64_t first_id = 0, ntotal = nlocal, nmin = nlocal, nmax = nlocal;
+#if MINI_HAVE_MPI
+    MPI_Exscan(&nlocal, &first_id, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0) first_id = 0;
+    MPI_Allreduce(&nlocal, &ntotal, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(&nlocal, &nmin, 1, MPI_INT64_T, MPI_MIN, MPI_COMM_WORLD);
+    MPI_Allreduce(&nlocal, &nmax, 1, MPI_INT64_T, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+    Box box;
+    for (int a = 0; a < 3; ++a) {
+        box.lo[a] = static_cast<double>(decomp.cell_begin[a]);
+        box.hi[a] = static_cast<double>(decomp.cell_begin[a] + decomp.cell_count[a]);
+    }
+
+    Particles particles("particles", static_cast<std::size_t>(nlocal));
+    particles.add_attribute<double>("velocity", 3);
+    particles.add_attribute<double>("energy");
+    particles.add_attribute<int64_t>("id");
+    init_particles(particles, box, first_id, 12345u + static_cast<uint64_t>(rank));
+    const unsigned nthreads = apl_thread_count(particles.size(), threads_per_rank(cfg.threads));
+    update_energy(particles, nthreads);
+
+    // visualization payload: all particles, or this rank's share of --keep
+    SampleOptions sample;
+    sample.method = cfg.sample == "reservoir"    ? SampleMethod::Reservoir
+                    : cfg.sample == "importance" ? SampleMethod::Importance
+                                                 : SampleMethod::Stride;
+    sample.seed = 777u + static_cast<uint64_t>(rank);
+    sample.weight = "energy";
+    sample.nthreads = nthreads;
+    const bool decimated = cfg.keep > 0;
+    if (decimated) {
+#if MINI_HAVE_MPI
+        sample.budget = rank_budget(static_cast<std::size_t>(cfg.keep), particles.size(), MPI_COMM_WORLD);
+#else
+        sample.budget = rank_budget(static_cast<std::size_t>(cfg.keep), particles.size());
+#endif
+    }
+    Particles reduced = particles.empty_like("particles");
+    const Particles& published = decimated ? reduced : particles;
+
+    if (rank == 0) {
+        std::cout << "particles_mini: " << cfg << " particles/rank=" << cfg.particles << " imbalance=" << cfg.imbalance
+                  << " ranks=" << size << " (" << decomp.dims[0] << "x" << decomp.dims[1] << "x" << decomp.dims[2]
+                  << ")\n  particles total " << ntotal << ", per rank " << nmin << " .. " << nmax << ", "
+                  << particles.bytes() / double(1 << 20) << " MiB on rank 0, " << nthreads << " threads\n";
+        if (decimated) {
+            std::cout << "  publishing " << std::min<int64_t>(cfg.keep, ntotal) << " particles (" << cfg.sample
+                      << " sampling), " << sample.budget << " on rank 0\n";
+        }
+    }
+
+    // --- Catalyst initialize ---
+    conduit_cpp::Node init;
+#if MINI_HAVE_MPI
+    init["catalyst/mpi_comm"].set(static_cast<int64_t>(MPI_Comm_c2f(MPI_COMM_WORLD)));
+#endif
+    init["catalyst/scripts/script/filename"].set(get_env_or("CATALYST_PIPELINE_PATH", "src/mini_apps/pipeline_trivial.py"));
+    init["catalyst/scripts/script/args"].append().set_string("--channel_names");
+    init["catalyst/scripts/script/args"].append().set_string("particles");
+    catalyst_status ierr = catalyst_initialize(conduit_cpp::c_node(&init));
+    if (ierr != catalyst_status_ok) {
+        std::cerr << "catalyst_initialize failed with code " << static_cast<int>(ierr) << "\n";
+#if MINI_HAVE_MPI
+        MPI_Abort(MPI_COMM_WORLD, 2);
+#else
+        return 2;
+#endif
+    }
+
+    // channel: point mesh over the SoA columns; nodes resolved on the first publish
+    PersistentChannel channel("particles");
+    ConduitPointMesh points(channel.data(), "coords", "points");
+    BlueprintVerifier verifier("mesh");
+    PhaseLog phases(cfg.steps);
+    const double dt = 0.05;
+
+    const auto t_loop = PhaseLog::now();
+    for (int step = 0; step < cfg.steps; ++step) {
+        const auto t_step = PhaseLog::now();
+
+        auto t0 = PhaseLog::now();
+        push(particles, box, dt, nthreads);
+        particles.touch();
+        phases.add(step, Phase::Compute, PhaseLog::since(t0));
+
+        t0 = PhaseLog::now();
+        update_energy(particles, nthreads);
+        phases.add(step, Phase::FieldUpdate, PhaseLog::since(t0));
+
+        t0 = PhaseLog::now();
+        channel.set_state(step, step * dt, rank);
+        if (decimated) decimate(particles, sample, reduced);
+        points.publish(published);
+        phases.add(step, Phase::NodeBuild, PhaseLog::since(t0));
+
+        t0 = PhaseLog::now();
+        conduit_cpp::Node verify_info;
+        const bool is_valid = verifier.check(channel.data(), verify_info);
+        phases.add(step, Phase::Verify, PhaseLog::since(t0));
+        if (!is_valid) {
+            std::cerr << "[Rank " << rank << "] Mesh blueprint verification FAILED at step " << step << ":\n";
+            verify_info.print();
+#if MINI_HAVE_MPI
+            MPI_Abort(MPI_COMM_WORLD, 3);
+#else
+            return 3;
+#endif
+        } else if (step == 0) {
+            std::cout << "[Rank " << rank << "] Mesh blueprint verification PASSED at step " << step << " ("
+                      << published.size() << " particles)\n";
+        }
+        if (step == 0 && rank == 0 && published.size() <= 1024 && !cfg.bench()) channel.exec().print();
+
+        t0 = PhaseLog::now();
+        ierr = catalyst_execute(channel.c_exec());
+        phases.add(step, Phase::Execute, PhaseLog::since(t0));
+        if (ierr != catalyst_status_ok) {
+            std::cerr << "catalyst_execute failed (step=" << step << ") code " << static_cast<int>(ierr) << "\n";
+            break;
+        }
+
+        if (cfg.sleep > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(cfg.sleep));
+        phases.add(step, Phase::Step, PhaseLog::since(t_step));
+    }
+    const double loop_wall = PhaseLog::since(t_loop);
+
+    // per-particle in-situ cost (slowest rank): node build + verify + execute
+    double local[2] = {phases.mean(Phase::NodeBuild) + phases.mean(Phase::Verify) + phases.mean(Phase::Execute),
+                       loop_wall},
+           mx[2] = {local[0], local[1]};
+#if MINI_HAVE_MPI
+    MPI_Reduce(local, mx, 2, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+#endif
+    if (rank == 0 && cfg.steps > 0) {
+        std::cout << "particles_mini: " << cfg.steps << " steps in " << mx[1] << " s; in situ " << 1e3 * mx[0]
+                  << " ms per step (slowest rank) = " << 1e9 * mx[0] / static_cast<double>(std::max<int64_t>(1, nmax))
+                  << " ns per particle of the largest rank\n"
+                  << "  point connectivity (not zero-copy) " << points.connectivity_bytes() / double(1 << 20)
+                  << " MiB on rank 0\n";
+    }
+    if (cfg.bench()) phases.write_csv(cfg.csv, "particles_mini/" + std::to_string(cfg.particles), cfg, decomp);
+
+    // --- Finalize ---
+    conduit_cpp::Node fin;
+    ierr = catalyst_finalize(conduit_cpp::c_node(&fin));
+    if (ierr != catalyst_status_ok) {
+        std::cerr << "catalyst_finalize failed with code " << static_cast<int>(ierr) << "\n";
+    }
+#if MINI_HAVE_MPI
+    decomp.free();
+    MPI_Finalize();
+#endif
+    return 0;
+}
@@ -0,0 +1,615 @@
+// Particle-in-cell mini app: a real compute cycle instead of sleep_for (multi-rank).
+// - Electrons (ParticleSoA: position, velocity, gathered field, id) in a box of --cells
+//   unit cells with a neutralising background; each rank owns its CartDecomp block and
+//   --particles N particles (mean over the ranks, --imbalance as in particles_mini)
+// - Cycle per step:
+//     deposit  CIC charge onto rho (apl deposit.h, per-thread private tiles; no atomics),
+//              ghost contributions added into the neighbours' cells (apl HaloExchange,
+//              accumulate mode) or mirrored at the walls
+//     solve    --work N Jacobi iterations (default 20) of lap(phi) = -(rho - mean),
+//              phi = 0 on the walls; every iteration updates the interior while the
+//              ghosts travel (apl HaloExchange, --halo datatype|packed), then the cells
+//              next to the faces; E = -grad(phi)
+//     gather   CIC interpolation of E into the particles' "efield" column (apl gather.h)
+//     push     leapfrog, reflecting walls
+//     migrate  particles that left the block go to their owner rank (apl migrate.h:
+//              neighbour exchange, all-to-all fallback for far jumps)
+//   every kernel is multithreaded (apl parallel_for_chunks), so memory-bandwidth and
+//   cache interference from the in-situ side show up in the timings
+// - Data lives in APL containers bound in a RegistryDynamic: grid fields rho, phi, E
+//   (GridField, one ghost layer) and vtkGhostType, particle container "electrons"
+// - Channel "pic": uniform topology "mesh" over owned + ghost cells carrying the grid
+//   fields (ConduitBridge) and point topology "particles" carrying every particle column
+//   (ConduitPointMesh), all zero-copy
+// - Per-phase timing (--csv): compute = PIC cycle, node_build = publish, verify,
+//   execute; rank 0 prints the per-kernel breakdown. --sleep is not used.
+
+#include <catalyst.hpp>
+#include <catalyst_conduit_blueprint.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/mini_bench.hpp"
+#include "common/mini_channel.hpp"
+#include "common/mini_config.hpp"
+#include "common/mini_decomp.hpp"
+#include "common/mini_verify.hpp"
+
+#include <mpi.h>
+#ifdef MPI_VERSION
+#  define MINI_HAVE_MPI 1
+#  define APL_HAVE_MPI 1   // HaloExchange, ParticleMigration
+#else
+#  define MINI_HAVE_MPI 0
+#endif
+
+#include "bpl.h"
+#include "conduit_bridge.h"
+
+using Particles = ParticleSoA<double, 3>;
+using Scalar = GridField<double, 3>;
+using Vector = GridField<vec<double, 3>, 3>;
+using GhostType = GridField<uint8_t, 3>;
+
+REGDYN_REGISTER_NAME_TYPE("rho", Scalar);
+REGDYN_REGISTER_NAME_TYPE("phi", Scalar);
+REGDYN_REGISTER_NAME_TYPE("E", Vector);
+REGDYN_REGISTER_NAME_TYPE("vtkGhostType", GhostType);
+REGDYN_REGISTER_NAME_TYPE("electrons", Particles);
+
+static std::string get_env_or(const char* key, const std::string& defval)
+{
+    const char* v = std::getenv(key);
+    return v ? std::string(v) : defval;
+}
+
+enum Kernel : int { Deposit, Solve, Gather, Push, Migrate, NumKernels };
+static const char* const kernel_names[NumKernels] = {"deposit", "solve", "gather", "push", "migrate"};
+
+using Range = std::array<std::ptrdiff_t, 2>;
+
+// fn(linear index) over cells r[0] .. r[1] - 1 of axis a, all allocated cells of the others.
+template <typename T, typename Fn>
+static void for_slab(const GridField<T, 3>& f, unsigned a, Range r, Fn&& fn)
+{
+    const auto g = static_cast<std::ptrdiff_t>(f.ghost);
+    std::array<Range, 3> box;
+    for (unsigned b = 0; b < 3; ++b) box[b] = {-g, static_cast<std::ptrdiff_t>(f.extents[b]) + g};
+    box[a] = r;
+    for (std::ptrdiff_t k = box[2][0]; k < box[2][1]; ++k)
+        for (std::ptrdiff_t j = box[1][0]; j < box[1][1]; ++j)
+            for (std::ptrdiff_t i = box[0][0]; i < box[0][1]; ++i) fn(f.index({i, j, k}));
+}
+
+// Deposit ghosts at the walls of the global box mirrored back into the owned cells
+// (reflecting particles). Slabs span the ghost layers of the other axes, so edge and
+// corner ghosts at two walls end up owned too, or in a ghost layer towards a neighbour.
+template <typename T>
+static void mirror_walls(const CartDecomp& d, GridField<T, 3>& f)
+{
+    const auto g = static_cast<std::ptrdiff_t>(f.ghost);
+    for (unsigned a = 0; a < 3; ++a) {
+        const auto n = static_cast<std::ptrdiff_t>(f.extents[a]);
+        const auto s = static_cast<std::ptrdiff_t>(f.stride(a));
+        for (std::ptrdiff_t c = -g; c < 0; ++c) {
+            if (d.coords[a] == 0) {
+                for_slab(f, a, {c, c + 1}, [&](std::size_t l) { f.values[l + (-2 * c - 1) * s] += f.values[l]; });
+            }
+            if (d.coords[a] == d.dims[a] - 1) {
+                for_slab(f, a, {n - c - 1, n - c}, [&](std::size_t l) { f.values[l + (2 * c + 1) * s] += f.values[l]; });
+            }
+        }
+    }
+}
+
+template <typename T>
+static void clear_ghosts(GridField<T, 3>& f)
+{
+    const auto g = static_cast<std::ptrdiff_t>(f.ghost);
+    for (unsigned a = 0; a < 3; ++a) {
+        const auto n = static_cast<std::ptrdiff_t>(f.extents[a]);
+        for_slab(f, a, {-g, 0}, [&](std::size_t l) { f.values[l] = T{}; });
+        for_slab(f, a, {n, n + g}, [&](std::size_t l) { f.values[l] = T{}; });
+    }
+}
+
+// Halo of one field: apl HaloExchange on the process grid, a ghost fill or (with
+// HaloOptions::accumulate) the reverse add of the deposit ghosts. Split into begin()/end()
+// so interior work can overlap; a single block without MPI has walls only.
+template <typename T>
+class FieldHalo
+{
+public:
+#if MINI_HAVE_MPI
+    FieldHalo(const CartDecomp& d, GridField<T, 3>& f, const HaloOptions& o) { m_halo.emplace(d.cart, f, o); }
+    void begin() { m_halo->begin(); }
+    void test() { m_halo->test(); }
+    void end() { m_halo->end(); }
+    // Release the persistent requests and datatypes (before MPI_Finalize).
+    void free() { m_halo.reset(); }
+#else
+    FieldHalo(const CartDecomp&, GridField<T, 3>&, const HaloOptions&) {}
+    void begin() {}
+    void test() {}
+    void end() {}
+    void free() {}
+#endif
+    void exchange()
+    {
+        begin();
+        end();
+    }
+
+private:
+#if MINI_HAVE_MPI
+    std::optional<HaloExchange<T, 3>> m_halo;
+#endif
+};
+
+struct PicState
+{
+    const CartDecomp& decomp;
+    unsigned nthreads;
+    double lo[3], hi[3];     // owned box (global coordinates, unit cells)
+    double charge;           // macro-particle charge (mean density 1)
+    GridMap<3> map;          // owned cells of this rank (unit spacing)
+    DepositWorkspace<double, 3> tiles;  // per-thread deposition tiles, kept across steps
+};
+
+// CIC deposit; the ghost contributions go to the owned cells of this rank (walls) or of
+// the neighbours (one HaloExchange round with corners), then the ghosts are cleared.
+static void deposit(PicState& st, const Particles& p, Scalar& rho, FieldHalo<double>& rho_halo)
+{
+    DepositOptions o;
+    o.shape = Shape::CIC;
+    o.scale = st.charge;
+    o.nthreads = st.nthreads;
+    ::deposit(p, rho, st.map, o, nullptr, &st.tiles);
+    mirror_walls(st.decomp, rho);
+    rho_halo.exchange();
+    clear_ghosts(rho);
+}
+
+using Box = std::array<std::array<std::ptrdiff_t, 2>, 3>;  // owned-cell ranges [lo, hi) per axis
+
+// fn(i, j, k) over the cells of b, k-planes chunked over threads.
+template <typename Fn>
+static void for_box(const Box& b, unsigned nthreads, Fn&& fn)
+{
+    const auto nz = static_cast<std::size_t>(std::max<std::ptrdiff_t>(0, b[2][1] - b[2][0]));
+    if (nz == 0 || b[1][1] <= b[1][0] || b[0][1] <= b[0][0]) return;
+    parallel_for_chunks(nz, std::min<unsigned>(nthreads, static_cast<unsigned>(nz)),
+                        [&](std::size_t lo, std::size_t hi, unsigned) {
+                            const std::ptrdiff_t kb = b[2][0] + static_cast<std::ptrdiff_t>(lo);
+                            const std::ptrdiff_t ke = b[2][0] + static_cast<std::ptrdiff_t>(hi);
+                            for (std::ptrdiff_t k = kb; k < ke; ++k)
+                                for (std::ptrdiff_t j = b[1][0]; j < b[1][1]; ++j)
+                                    for (std::ptrdiff_t i = b[0][0]; i < b[0][1]; ++i) fn(i, j, k);
+                        });
+}
+
+static Box owned_box(const Scalar& f)
+{
+    Box b;
+    for (unsigned a = 0; a < 3; ++a) b[a] = {0, static_cast<std::ptrdiff_t>(f.extents[a])};
+    return b;
+}
+
+template <typename Fn>
+static void for_owned(const Scalar& f, unsigned nthreads, Fn&& fn)
+{
+    for_box(owned_box(f), nthreads, fn);
+}
+
+// Owned cells next to a face (a 7-point stencil reads ghosts there) as disjoint boxes;
+// the rest is `interior`.
+static std::vector<Box> boundary_boxes(const Scalar& f, Box& interior)
+{
+    std::array<std::ptrdiff_t, 3> n;
+    for (unsigned a = 0; a < 3; ++a) {
+        n[a] = static_cast<std::ptrdiff_t>(f.extents[a]);
+        const std::ptrdiff_t lo = std::min<std::ptrdiff_t>(1, n[a]);
+        interior[a] = {lo, std::max(n[a] - 1, lo)};
+    }
+    std::vector<Box> boxes;
+    for (int a = 2; a >= 0; --a) {
+        Box b;
+        for (int c = 0; c < 3; ++c) b[c] = c < a ? std::array<std::ptrdiff_t, 2>{0, n[c]} : interior[c];
+        b[a] = {0, interior[a][0]};
+        boxes.push_back(b);
+        b[a] = {interior[a][1], n[a]};
+        boxes.push_back(b);
+    }
+    return boxes;
+}
+
+static void solve(PicState& st, const Scalar& rho, Scalar& phi, Scalar& next, Vector& E, int iterations,
+                  FieldHalo<double>& phi_fill, FieldHalo<vec<double, 3>>& e_fill)
+{
+    double local = 0.0, mean = 0.0;
+    for_owned(rho, 1, [&](std::ptrdiff_t i, std::ptrdiff_t j, std::ptrdiff_t k) { local += rho(i, j, k); });
+    mean = local;
+#if MINI_HAVE_MPI
+    MPI_Allreduce(&local, &mean, 1, MPI_DOUBLE, MPI_SUM, st.decomp.cart);
+#endif
+    mean /= static_cast<double>(st.decomp.global_cell_total());
+
+    Box interior;
+    const std::vector<Box> boundary = boundary_boxes(phi, interior);
+    const std::size_t sy = phi.stride(1), sz = phi.stride(2);
+    for (int it = 0; it < iterations; ++it) {
+        const double* p = phi.data();
+        double* q = next.data();
+        auto update = [&](std::ptrdiff_t i, std::ptrdiff_t j, std::ptrdiff_t k) {
+            const std::size_t c = phi.index({i, j, k});
+            q[c] = (p[c - 1] + p[c + 1] + p[c - sy] + p[c + sy] + p[c - sz] + p[c + sz] + (rho.values[c] - mean)) /
+                   6.0;
+        };
+        // interior while the ghosts travel, then the cells next to the faces
+        phi_fill.begin();
+        for_box(interior, st.nthreads, update);
+        phi_fill.end();
+        for (const Box& b : boundary) for_box(b, st.nthreads, update);
+        std::swap(phi.values, next.values);
+    }
+    phi_fill.exchange();
+
+    const double* p = phi.data();
+    for_owned(phi, st.nthreads, [&](std::ptrdiff_t i, std::ptrdiff_t j, std::ptrdiff_t k) {
+        const std::size_t c = phi.index({i, j, k});
+        E.values[c] = {-0.5 * (p[c + 1] - p[c - 1]), -0.5 * (p[c + sy] - p[c - sy]), -0.5 * (p[c + sz] - p[c - sz])};
+    });
+    e_fill.exchange();
+}
+
+// CIC interpolation of E at the particle positions into column "efield".
+static void gather(const PicState& st, Particles& p, const Vector& E)
+{
+    GatherOptions o;
+    o.shape = Shape::CIC;
+    o.nthreads = st.nthreads;
+    ::gather(E, p, st.map, "efield", o);
+}
+
+// Leapfrog with q/m = -1; reflecting walls at the global box.
+static void push(const PicState& st, Particles& p, double dt)
+{
+    const std::size_t vel = p.find("velocity"), ef = p.find("efield");
+    double* q[3] = {p.pos(0), p.pos(1), p.pos(2)};
+    double* v[3] = {p.data<double>(vel, 0), p.data<double>(vel, 1), p.data<double>(vel, 2)};
+    const double* e[3] = {p.data<double>(ef, 0), p.data<double>(ef, 1), p.data<double>(ef, 2)};
+    double wall[3];
+    for (int a = 0; a < 3; ++a) wall[a] = static_cast<double>(st.decomp.global_cells[a]);
+
+    parallel_for_chunks(p.size(), apl_thread_count(p.size(), st.nthreads), [&](std::size_t b, std::size_t n, unsigned) {
+        for (int a = 0; a < 3; ++a) {
+            double* qa = q[a];
+            double* va = v[a];
+            const double* ea = e[a];
+            const double hi = wall[a];
+            for (std::size_t i = b; i < n; ++i) {
+                va[i] -= ea[i] * dt;
+                qa[i] += va[i] * dt;
+                if (qa[i] < 0.0) { qa[i] = -qa[i]; va[i] = -va[i]; }
+                if (qa[i] >= hi) { qa[i] = std::nextafter(2.0 * hi - qa[i], 0.0); va[i] = -va[i]; }
+            }
+        }
+    });
+}
+
+// Particles outside the owned box go to the rank owning their position (apl ParticleMigration:
+// neighbour exchange, all-to-all only if a particle skipped a block); one block keeps all.
+class Migration
+{
+public:
+#if MINI_HAVE_MPI
+    Migration(const CartDecomp& d, unsigned nthreads) : m_mig(d.cart, planes(d), options(nthreads)) {}
+    void run(Particles& p) { m_mig.migrate(p); }
+
+private:
+    // Block boundaries per axis, as split by CartDecomp.
+    static std::array<std::vector<double>, 3> planes(const CartDecomp& d)
+    {
+        std::array<std::vector<double>, 3> p;
+        for (int a = 0; a < 3; ++a) {
+            for (int c = 0; c < d.dims[a]; ++c) {
+                int64_t begin = 0, count = 0;
+                CartDecomp::split(d.global_cells[a], d.dims[a], c, begin, count);
+                p[a].push_back(static_cast<double>(begin));
+            }
+            p[a].push_back(static_cast<double>(d.global_cells[a]));
+        }
+        return p;
+    }
+
+    static MigrationOptions options(unsigned nthreads)
+    {
+        MigrationOptions o;
+        o.nthreads = nthreads;
+        return o;
+    }
+
+    ParticleMigration<double, 3> m_mig;
+#else
+    Migration(const CartDecomp&, unsigned) {}
+    void run(Particles&) {}
+#endif
+};
+
+// Uniform positions, thermal velocities plus a long-wavelength drift along x (plasma oscillation).
+static void init_particles(Particles& p, const PicState& st, int64_t first_id, uint64_t seed)
+{
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::normal_distribution<double> g(0.0, 0.2);
+    const std::size_t vel = p.find("velocity"), id = p.find("id");
+    const double lx = static_cast<double>(st.decomp.global_cells[0]);
+    for (std::size_t i = 0; i < p.size(); ++i) {
+        for (unsigned a = 0; a < 3; ++a) {
+            p.pos(a)[i] = st.lo[a] + u(gen) * (st.hi[a] - st.lo[a]);
+            p.data<double>(vel, a)[i] = g(gen);
+        }
+        p.data<double>(vel, 0)[i] += 0.5 * std::sin(2.0 * std::numbers::pi * p.pos(0)[i] / lx);
+        p.data<int64_t>(id)[i] = first_id + static_cast<int64_t>(i);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // --- MPI init ---
+    int rank = 0, size = 1;
+#if MINI_HAVE_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+    // --- Configuration and decomposition ---
+    auto fail = [&](const std::string& msg) {
+        if (rank == 0) {
+            std::cerr << msg << "\n";
+            MiniConfig::usage(std::cerr, argv[0]);
+        }
+#if MINI_HAVE_MPI
+        MPI_Finalize();
+#endif
+        return 1;
+    };
+    MiniConfig cfg;
+    CartDecomp decomp;
+    try {
+        cfg = MiniConfig::parse(argc, argv);
+#if MINI_HAVE_MPI
+        decomp = cfg.cells_per_rank ? CartDecomp::create_weak(MPI_COMM_WORLD, cfg.cells)
+                                    : CartDecomp::create(MPI_COMM_WORLD, cfg.cells);
+#else
+        decomp = CartDecomp::serial(cfg.cells);
+#endif
+    } catch (const std::exception& e) {
+        return fail(e.what());
+    }
+    if (cfg.help) {
+        if (rank == 0) MiniConfig::usage(std::cout, argv[0]);
+#if MINI_HAVE_MPI
+        MPI_Finalize();
+#endif
+        return 0;
+    }
+    const int iterations = cfg.work > 0 ? cfg.work : 20;
+    const double dt = 0.1;
+
+    // --- Particles of this rank ---
+    const int64_t nlocal = particles_of_rank(cfg.particles, cfg.imbalance, rank, size);
+    int64_t first_id = 0, ntotal = nlocal;
+#if MINI_HAVE_MPI
+    MPI_Exscan(&nlocal, &first_id, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0) first_id = 0;
+    MPI_Allreduce(&nlocal, &ntotal, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+    PicState st{decomp, 0, {}, {}, 0.0, {}, {}};
+    for (int a = 0; a < 3; ++a) {
+        st.lo[a] = static_cast<double>(decomp.cell_begin[a]);
+        st.hi[a] = static_cast<double>(decomp.cell_begin[a] + decomp.cell_count[a]);
+        st.map.origin[a] = st.lo[a];
+    }
+    st.charge = -static_cast<double>(decomp.global_cell_total()) / static_cast<double>(std::max<int64_t>(1, ntotal));
+    st.nthreads = threads_per_rank(cfg.threads);
+
+    const std::array<std::size_t, 3> ext{static_cast<std::size_t>(decomp.cell_count[0]),
+                                         static_cast<std::size_t>(decomp.cell_count[1]),
+                                         static_cast<std::size_t>(decomp.cell_count[2])};
+    Scalar rho("rho", ext, 1), phi("phi", ext, 1), phi_next("phi_next", ext, 1);
+    Vector efield("E", ext, 1);
+    GhostType ghost_type("vtkGhostType", ext, 1, uint8_t{1});  // DUPLICATECELL outside the owned block
+    for_owned(rho, 1, [&](std::ptrdiff_t i, std::ptrdiff_t j, std::ptrdiff_t k) { ghost_type(i, j, k) = 0; });
+
+    Particles electrons("electrons", static_cast<std::size_t>(nlocal));
+    electrons.add_attribute<double>("velocity", 3);
+    electrons.add_attribute<double>("efield", 3);
+    electrons.add_attribute<int64_t>("id");
+    init_particles(electrons, st, first_id, 4242u + static_cast<uint64_t>(rank));
+
+    VisAdaptorBase vis(std::make_shared<RegistryDynamic>());
+    RegistryDynamic& reg = vis.get_registry();
+    reg.Set<"rho">(rho);
+    reg.Set<"phi">(phi);
+    reg.Set<"E">(efield);
+    reg.Set<"vtkGhostType">(ghost_type);
+    reg.Set<"electrons">(electrons);
+
+    if (rank == 0) {
+        std::cout << "pic_mini: " << cfg << " particles/rank=" << cfg.particles << " imbalance=" << cfg.imbalance
+                  << " jacobi=" << iterations << " ranks=" << size << " (" << decomp.dims[0] << "x" << decomp.dims[1]
+                  << "x" << decomp.dims[2] << "), " << st.nthreads << " threads\n  particles total " << ntotal
+                  << ", " << static_cast<double>(ntotal) / static_cast<double>(decomp.global_cell_total())
+                  << " per cell\n";
+    }
+
+    // --- Catalyst initialize ---
+    conduit_cpp::Node init;
+#if MINI_HAVE_MPI
+    init["catalyst/mpi_comm"].set(static_cast<int64_t>(MPI_Comm_c2f(MPI_COMM_WORLD)));
+#endif
+    init["catalyst/scripts/script/filename"].set(get_env_or("CATALYST_PIPELINE_PATH", "src/mini_apps/pipeline_trivial.py"));
+    init["catalyst/scripts/script/args"].append().set_string("--channel_names");
+    init["catalyst/scripts/script/args"].append().set_string("pic");
+    catalyst_status ierr = catalyst_initialize(conduit_cpp::c_node(&init));
+    if (ierr != catalyst_status_ok) {
+        std::cerr << "catalyst_initialize failed with code " << static_cast<int>(ierr) << "\n";
+#if MINI_HAVE_MPI
+        MPI_Abort(MPI_COMM_WORLD, 2);
+#else
+        return 2;
+#endif
+    }
+
+    // channel: uniform mesh over owned + ghost cells once; fields by the bridge, particles
+    // by the point mesh every step
+    PersistentChannel channel("pic");
+    {
+        conduit_cpp::Node data = channel.data();
+        data["coordsets/coords/type"].set("uniform");
+        data["coordsets/coords/dims/i"].set(static_cast<int64_t>(rho.allocated(0) + 1));
+        data["coordsets/coords/dims/j"].set(static_cast<int64_t>(rho.allocated(1) + 1));
+        data["coordsets/coords/dims/k"].set(static_cast<int64_t>(rho.allocated(2) + 1));
+        data["coordsets/coords/origin/x"].set(st.lo[0] - 1.0);
+        data["coordsets/coords/origin/y"].set(st.lo[1] - 1.0);
+        data["coordsets/coords/origin/z"].set(st.lo[2] - 1.0);
+        data["coordsets/coords/spacing/dx"].set(1.0);
+        data["coordsets/coords/spacing/dy"].set(1.0);
+        data["coordsets/coords/spacing/dz"].set(1.0);
+        data["topologies/mesh/type"].set("uniform");
+        data["topologies/mesh/coordset"].set("coords");
+    }
+    ConduitBridgeOptions opts;
+    opts.channel = "pic";
+    opts.select = {"!electrons"};
+    ConduitBridge bridge(opts);
+    ConduitPointMesh points(channel.data(), "particle_coords", "particles");
+    BlueprintVerifier verifier("mesh");
+    PhaseLog phases(cfg.steps);
+    HaloOptions face_opts, full_opts, add_opts;
+    face_opts.corners = false;  // Jacobi: 7-point stencil
+    add_opts.accumulate = true;
+    face_opts.strategy = full_opts.strategy = add_opts.strategy =
+        cfg.halo == "packed" ? HaloStrategy::Packed : HaloStrategy::Datatype;
+    FieldHalo<double> rho_halo(decomp, rho, add_opts);
+    FieldHalo<double> phi_fill(decomp, phi, face_opts);
+    FieldHalo<vec<double, 3>> e_fill(decomp, efield, full_opts);  // CIC gather reads edges and corners
+    Migration migration(decomp, st.nthreads);
+    double kernel_s[NumKernels] = {};
+
+    // E at t = 0, so the first push has a field
+    deposit(st, electrons, rho, rho_halo);
+    solve(st, rho, phi, phi_next, efield, iterations, phi_fill, e_fill);
+    gather(st, electrons, efield);
+
+    const auto t_loop = PhaseLog::now();
+    for (int step = 0; step < cfg.steps; ++step) {
+        const auto t_step = PhaseLog::now();
+
+        auto t0 = PhaseLog::now();
+        auto tk = t0;
+        auto lap = [&](Kernel k) {
+            const auto t = PhaseLog::now();
+            kernel_s[k] += std::chrono::duration<double>(t - tk).count();
+            tk = t;
+        };
+        push(st, electrons, dt);
+        lap(Push);
+        migration.run(electrons);
+        lap(Migrate);
+        deposit(st, electrons, rho, rho_halo);
+        lap(Deposit);
+        solve(st, rho, phi, phi_next, efield, iterations, phi_fill, e_fill);
+        lap(Solve);
+        gather(st, electrons, efield);
+        lap(Gather);
+        rho.touch(); phi.touch(); efield.touch(); electrons.touch();
+        phases.add(step, Phase::Compute, PhaseLog::since(t0));
+
+        t0 = PhaseLog::now();
+        channel.set_state(step, step * dt, rank);
+        const ConduitBridge::Stats s = bridge.publish(reg, channel.data());
+        points.publish(*reg.get_named<Particles>("electrons"));
+        phases.add(step, Phase::NodeBuild, PhaseLog::since(t0));
+
+        t0 = PhaseLog::now();
+        conduit_cpp::Node verify_info;
+        const bool is_valid = verifier.check(channel.data(), verify_info);
+        phases.add(step, Phase::Verify, PhaseLog::since(t0));
+        if (!is_valid) {
+            std::cerr << "[Rank " << rank << "] Mesh blueprint verification FAILED at step " << step << ":\n";
+            verify_info.print();
+#if MINI_HAVE_MPI
+            MPI_Abort(MPI_COMM_WORLD, 3);
+#else
+            return 3;
+#endif
+        } else if (step == 0) {
+            std::cout << "[Rank " << rank << "] Mesh blueprint verification PASSED at step " << step << " ("
+                      << s.bindings << " grid fields, " << electrons.size() << " particles)\n";
+        }
+        if (step == 0 && rank == 0 && electrons.size() <= 64 && !cfg.bench()) channel.exec().print();
+
+        t0 = PhaseLog::now();
+        ierr = catalyst_execute(channel.c_exec());
+        phases.add(step, Phase::Execute, PhaseLog::since(t0));
+        if (ierr != catalyst_status_ok) {
+            std::cerr << "catalyst_execute failed (step=" << step << ") code " << static_cast<int>(ierr) << "\n";
+            break;
+        }
+        phases.add(step, Phase::Step, PhaseLog::since(t_step));
+    }
+    const double loop_wall = PhaseLog::since(t_loop);
+
+    // per-kernel time per step, slowest rank
+    double mx[NumKernels + 1];
+    std::copy(kernel_s, kernel_s + NumKernels, mx);
+    mx[NumKernels] = loop_wall;
+#if MINI_HAVE_MPI
+    double local[NumKernels + 1];
+    std::copy(mx, mx + NumKernels + 1, local);
+    MPI_Reduce(local, mx, NumKernels + 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+#endif
+    if (rank == 0 && cfg.steps > 0) {
+        std::cout << "pic_mini: " << cfg.steps << " steps in " << mx[NumKernels] << " s; per step (slowest rank):";
+        for (int k = 0; k < NumKernels; ++k) std::cout << " " << kernel_names[k] << " " << 1e3 * mx[k] / cfg.steps << " ms";
+        std::cout << "\n";
+    }
+    if (cfg.bench()) phases.write_csv(cfg.csv, "pic_mini", cfg, decomp);
+
+    reg.Unset<"electrons">();
+    reg.Unset<"vtkGhostType">();
+    reg.Unset<"E">();
+    reg.Unset<"phi">();
+    reg.Unset<"rho">();
+
+    // --- Finalize ---
+    conduit_cpp::Node fin;
+    ierr = catalyst_finalize(conduit_cpp::c_node(&fin));
+    if (ierr != catalyst_status_ok) {
+        std::cerr << "catalyst_finalize failed with code " << static_cast<int>(ierr) << "\n";
+    }
+    rho_halo.free();
+    phi_fill.free();
+    e_fill.free();
+#if MINI_HAVE_MPI
+    decomp.free();
+    MPI_Finalize();
+#endif
+    return 0;
+}
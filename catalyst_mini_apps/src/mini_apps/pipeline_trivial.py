@@ -54,6 +54,9 @@ _arg_list = paraview.catalyst.get_args()
 _parser = argparse.ArgumentParser()
 _parser.add_argument("--channel_names", nargs="*", default=["uniform"], help="Channel names")
 _parser.add_argument("--VTKextracts", default="ON", help="(ignored)")
+_parser.add_argument("--merge_blocks", default="ON",
+                     help="ON: merge the partitions for live view; OFF: show them directly "
+                          "(the channel publishes extents and vtkGhostType)")
 _parsed = _parser.parse_args(_arg_list)
 
 # Configure Catalyst run options
@@ -89,7 +92,7 @@ for cname in _parsed.channel_names:
         extractors[cname] = create_VTPD_extractor(cname, proxy, 1)
 
     # 3. Setup Live Visualization (create filter, but don't show it yet)
-    if options.EnableCatalystLive:
+    if options.EnableCatalystLive and _parsed.merge_blocks == "ON":
         _log(f"Creating MergeBlocks filter for Live-Vis on '{cname}'")
         merged = MergeBlocks(Input=proxy)
         merged.MergePartitionsOnly = 1
@@ -143,6 +146,9 @@ def catalyst_execute(info):
             #    This makes the filter visible in the ParaView GUI.
             if info.cycle == 0 and options.EnableCatalystLive:
                 Show(live_filter)
+        elif info.cycle == 0 and options.EnableCatalystLive:
+            # Partitioned pieces with extents and ghost cells: no merge needed
+            Show(proxy)
 
     if options.EnableCatalystLive:
         time.sleep(0.5)
@@ -0,0 +1,271 @@
+// APL registry published through Catalyst without hand-built field nodes.
+// - The simulation binds its fields and particle containers in an APL RegistryDynamic
+//   (apl/src_dynamic); ConduitBridge (conduit_bridge.h) walks the registry and emits a
+//   Blueprint field for every binding, zero-copy with the binding's own dtype
+// - Fields of several types: double, int32 and AoS vec<double,3> / vec<float,2> (mcarray
+//   components with offsets and strides into the interleaved storage)
+// - Each rank owns a fixed 8x8x8 cell block (APL fields have a compile-time size), blocks
+//   are stacked along x; the particle container "probe" is one moving point
+// - Runtime selection: --select / MINI_SELECT ("E,pressure", "p*", "!material"), the
+//   channel and topology names via APL_CONDUIT_* (see conduit_bridge.h)
+// - --publish schema uses ConduitSchemaBinding instead: paths, dtypes and strides of all
+//   bindings fixed at compile time (schema.h), a step only re-points resolved handles;
+//   the nodes are checked against the schema (conforms()) after the first publish;
+//   rank 0 prints the mean per-step publish time of either path
+
+#include <catalyst.hpp>
+#include <catalyst_conduit_blueprint.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "common/mini_config.hpp"
+#include "common/mini_verify.hpp"
+
+#include "bpl.h"
+#include "conduit_bridge.h"
+
+#include <mpi.h>
+#ifdef MPI_VERSION
+#  define MINI_HAVE_MPI 1
+#else
+#  define MINI_HAVE_MPI 0
+#endif
+
+constexpr int BX = 8, BY = 8, BZ = 8;
+constexpr unsigned NC = BX * BY * BZ;
+
+REGDYN_REGISTER_NAME_TYPE("pressure", Field<double, NC>);
+REGDYN_REGISTER_NAME_TYPE("material", Field<int32_t, NC>);
+REGDYN_REGISTER_NAME_TYPE("E", Field<vec<double, 3>, NC>);
+REGDYN_REGISTER_NAME_TYPE("flux", Field<vec<float, 2>, NC>);
+REGDYN_REGISTER_NAME_TYPE("probe", ParticleBase<double, 3>);
+
+static std::string get_env_or(const char* key, const std::string& defval)
+{
+    const char* v = std::getenv(key);
+    return v ? std::string(v) : defval;
+}
+
+// Block of this rank: uniform cells, plus a point coordset/topology for the particle
+// containers (the probe position is referenced, not copied). Blueprint requires an
+// integer connectivity for unstructured topologies: the probe is the single point 0.
+static void build_meshes(conduit_cpp::Node data, double ox, const ConduitBridgeOptions& opts,
+                         const ParticleBase<double, 3>& probe)
+{
+    data["coordsets/coords/type"].set("uniform");
+    data["coordsets/coords/dims/i"].set(BX + 1);
+    data["coordsets/coords/dims/j"].set(BY + 1);
+    data["coordsets/coords/dims/k"].set(BZ + 1);
+    data["coordsets/coords/origin/x"].set(ox);
+    data["coordsets/coords/origin/y"].set(0.0);
+    data["coordsets/coords/origin/z"].set(0.0);
+    data["coordsets/coords/spacing/dx"].set(1.0);
+    data["coordsets/coords/spacing/dy"].set(1.0);
+    data["coordsets/coords/spacing/dz"].set(1.0);
+    data["topologies/" + opts.topology + "/type"].set("uniform");
+    data["topologies/" + opts.topology + "/coordset"].set("coords");
+
+    const DataDescriptor d = probe.describe();
+    data["coordsets/particle_coords/type"].set("explicit");
+    for (unsigned c = 0; c < d.components; ++c) {
+        conduit_set_external(data["coordsets/particle_coords/values/" + conduit_component_name(c, d.components)],
+                             d.component(c));
+    }
+    data["topologies/" + opts.particle_topology + "/type"].set("unstructured");
+    data["topologies/" + opts.particle_topology + "/coordset"].set("particle_coords");
+    data["topologies/" + opts.particle_topology + "/elements/shape"].set("point");
+    static int32_t probe_connectivity[1] = {0};
+    data["topologies/" + opts.particle_topology + "/elements/connectivity"].set_external(probe_connectivity, 1);
+}
+
+// One simulation step on the rank's block (global cell index i0 + i along x).
+static void update(int step, int i0, Field<double, NC>& p, Field<int32_t, NC>& m, Field<vec<double, 3>, NC>& e,
+                   Field<vec<float, 2>, NC>& f, ParticleBase<double, 3>& probe)
+{
+    const double t = 0.1 * step;
+    for (int k = 0; k < BZ; ++k) {
+        for (int j = 0; j < BY; ++j) {
+            for (int i = 0; i < BX; ++i) {
+                const std::size_t c = static_cast<std::size_t>(i + BX * (j + BY * k));
+                const double x = i0 + i + 0.5, y = j + 0.5, z = k + 0.5;
+                p.data[c] = std::sin(0.3 * x + t) * std::cos(0.3 * y) + 0.1 * z;
+                m.data[c] = (i0 + i + j + k + step) % 3;
+                e.data[c] = {std::cos(0.3 * x + t), std::sin(0.3 * y + t), 0.05 * z};
+                f.data[c] = {static_cast<float>(p.data[c] * e.data[c][0]), static_cast<float>(p.data[c] * e.data[c][1])};
+            }
+        }
+    }
+    probe.data = {i0 + 0.5 * BX + 3.0 * std::cos(t), 0.5 * BY + 3.0 * std::sin(t), 0.5 * BZ};
+    p.touch(); m.touch(); e.touch(); f.touch(); probe.touch();
+}
+
+int main(int argc, char** argv)
+{
+    int rank = 0, size = 1;
+#if MINI_HAVE_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+    MiniConfig cfg;
+    try {
+        cfg = MiniConfig::parse(argc, argv);
+    } catch (const std::exception& e) {
+        if (rank == 0) {
+            std::cerr << e.what() << "\n";
+            MiniConfig::usage(std::cerr, argv[0]);
+        }
+#if MINI_HAVE_MPI
+        MPI_Finalize();
+#endif
+        return 1;
+    }
+    if (cfg.help) {
+        if (rank == 0) MiniConfig::usage(std::cout, argv[0]);
+#if MINI_HAVE_MPI
+        MPI_Finalize();
+#endif
+        return 0;
+    }
+
+    // --- Registry: the simulation binds its data once ---
+    Field<double, NC> pressure("pressure", 0.0);
+    Field<int32_t, NC> material("material", 0);
+    Field<vec<double, 3>, NC> efield("E", vec<double, 3>{});
+    Field<vec<float, 2>, NC> flux("flux", vec<float, 2>{});
+    ParticleBase<double, 3> probe("probe", 0.0);
+
+    VisAdaptorBase vis(std::make_shared<RegistryDynamic>());
+    RegistryDynamic& reg = vis.get_registry();
+    reg.Set<"pressure">(pressure);
+    reg.Set<"material">(material);
+    reg.Set<"E">(efield);
+    reg.Set<"flux">(flux);
+    reg.Set<"probe">(probe);
+
+    ConduitBridge bridge;  // channel/topologies from APL_CONDUIT_*
+    const bool use_schema = cfg.publish == "schema";
+    if (!cfg.select.empty()) {
+        if (use_schema && rank == 0) std::cerr << "registry_mini: --select is ignored with --publish schema\n";
+        bridge.select(ConduitBridgeOptions::split_list(cfg.select));
+    }
+    const int i0 = rank * BX;
+    update(0, i0, pressure, material, efield, flux, probe);
+
+    if (rank == 0) {
+        std::cout << "registry_mini: " << BX << "x" << BY << "x" << BZ << " cells/rank, steps=" << cfg.steps
+                  << " ranks=" << size << " channel=" << bridge.channel()
+                  << " publish=" << cfg.publish << " select=" << (use_schema || cfg.select.empty() ? "all" : cfg.select)
+                  << "\n";
+    }
+
+    // --- Catalyst initialize ---
+    conduit_cpp::Node init;
+#if MINI_HAVE_MPI
+    init["catalyst/mpi_comm"].set(static_cast<int64_t>(MPI_Comm_c2f(MPI_COMM_WORLD)));
+#endif
+    init["catalyst/scripts/script/filename"].set(get_env_or("CATALYST_PIPELINE_PATH", "src/mini_apps/pipeline_trivial.py"));
+    init["catalyst/scripts/script/args"].append().set_string("--channel_names");
+    init["catalyst/scripts/script/args"].append().set_string(bridge.channel());
+    catalyst_status ierr = catalyst_initialize(conduit_cpp::c_node(&init));
+    if (ierr != catalyst_status_ok) {
+        std::cerr << "catalyst_initialize failed with code " << static_cast<int>(ierr) << "\n";
+#if MINI_HAVE_MPI
+        MPI_Abort(MPI_COMM_WORLD, 2);
+#else
+        return 2;
+#endif
+    }
+
+    // --- Exec tree: meshes once, fields by the bridge every step ---
+    conduit_cpp::Node exec;
+    exec["catalyst/channels/" + bridge.channel() + "/type"].set("mesh");
+    conduit_cpp::Node data = exec["catalyst/channels/" + bridge.channel() + "/data"];
+    build_meshes(data, static_cast<double>(i0), bridge.options(), probe);
+
+    // compile-time alternative: field nodes created here, objects resolved once
+    using Schema = ConduitSchemaBinding<"pressure", "material", "E", "flux", "probe">;
+    std::optional<Schema> schema;
+    if (use_schema) {
+        const ConduitBridgeOptions& o = bridge.options();
+        schema.emplace(data, o.topology, o.association, o.particle_topology);
+        schema->bind(reg);
+    }
+
+    BlueprintVerifier verifier("mesh");
+    double publish_s = 0.0;
+    for (int step = 0; step < cfg.steps; ++step) {
+        update(step, i0, pressure, material, efield, flux, probe);
+
+        exec["catalyst/state/cycle"].set(static_cast<int32_t>(step));
+        exec["catalyst/state/time"].set(static_cast<double>(step));
+        exec["catalyst/state/domain_id"].set(static_cast<int32_t>(rank));
+        const auto t0 = std::chrono::steady_clock::now();
+        ConduitBridge::Stats s;
+        if (schema) {
+            schema->publish();
+            s.schema_changed = step == 0;
+            s.bindings = 5;
+            s.arrays = Schema::arrays();
+        } else {
+            s = bridge.publish(reg, data);
+        }
+        publish_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (schema && step == 0 && !schema->conforms()) {
+            // a value node whose dtype or length differs from the compile-time layout
+            std::cerr << "[Rank " << rank << "] schema binding does not match the published nodes\n";
+#if MINI_HAVE_MPI
+            MPI_Abort(MPI_COMM_WORLD, 3);
+#else
+            return 3;
+#endif
+        }
+
+        conduit_cpp::Node verify_info;
+        if (!verifier.check(data, verify_info)) {
+            std::cerr << "[Rank " << rank << "] Mesh blueprint verification FAILED at step " << step << ":\n";
+            verify_info.print();
+#if MINI_HAVE_MPI
+            MPI_Abort(MPI_COMM_WORLD, 3);
+#else
+            return 3;
+#endif
+        }
+        if (rank == 0 && s.schema_changed) {
+            std::cout << "registry_mini: step " << step << " publishes " << s.bindings << " bindings as "
+                      << s.arrays << " external arrays (none copied)\n";
+            if (!cfg.bench()) exec.print();
+        }
+
+        ierr = catalyst_execute(conduit_cpp::c_node(&exec));
+        if (ierr != catalyst_status_ok) {
+            std::cerr << "catalyst_execute failed (step=" << step << ") code " << static_cast<int>(ierr) << "\n";
+            break;
+        }
+        if (cfg.sleep > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(cfg.sleep));
+    }
+
+    if (rank == 0 && cfg.steps > 0) {
+        std::cout << "registry_mini: publish (" << cfg.publish << ") " << 1e6 * publish_s / cfg.steps
+                  << " us per step (rank 0)\n";
+    }
+
+    conduit_cpp::Node fin;
+    ierr = catalyst_finalize(conduit_cpp::c_node(&fin));
+    if (ierr != catalyst_status_ok) {
+        std::cerr << "catalyst_finalize failed with code " << static_cast<int>(ierr) << "\n";
+    }
+#if MINI_HAVE_MPI
+    MPI_Finalize();
+#endif
+    return 0;
+}
@@ -1,17 +1,37 @@
 // Minimal 3D uniform-mesh simulation with Catalyst 2.0 (multi-rank ready)
 // - Initializes Catalyst with a Python pipeline (pipeline_trivial.py)
+// - Global mesh size, steps and field count from the command line / environment
+//   (see common/mini_config.hpp); 3D block decomposition over any rank count
 // - Each step updates a 3D uniform mesh channel named "uniform"
-// - Field values change order every step; sleeps 1s to mimic a simulation
+// - The exec tree is built once (PersistentChannel); a step only updates the state
+//   scalars and the external field pointer
+// - Field values change order every step; sleeps 1s to mimic a simulation, or runs a
+//   synthetic compute kernel (--work); --csv enables the per-phase benchmark output
+// - --async runs catalyst_execute on a separate thread on double-buffered copies of the
+//   fields (common/mini_async.hpp); the run ends with the simulation throughput
+// - --budget F runs in situ only as often as keeps its share of the wall time near F
+//   (common/mini_trigger.hpp); --must-fire steps always run
 
 #include <catalyst.hpp>
 #include <catalyst_conduit_blueprint.hpp>
 
 #include <chrono>
 #include <cstdint>
+#include <optional>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <thread>
+#include <vector>
+
+#include "common/mini_async.hpp"
+#include "common/mini_bench.hpp"
+#include "common/mini_channel.hpp"
+#include "common/mini_config.hpp"
+#include "common/mini_decomp.hpp"
+#include "common/mini_trigger.hpp"
+#include "common/mini_verify.hpp"
 
 #include <mpi.h>
 #ifdef MPI_VERSION
@@ -27,12 +47,12 @@ static std::string get_env_or(const char* key, const std::string& defval)
     return v ? std::string(v) : defval;
 }
 
+// `piece`: the published block of this rank (CartDecomp::ghosted), nx/ny/nz its points.
 static void build_uniform3d_mesh(conduit_cpp::Node data,
                                  int nx, int ny, int nz,
                                  double ox, double oy, double oz,
                                  double dx, double dy, double dz,
-                                 const int32_t* vals_ptr, int64_t ncell,
-                                 int rank, int size)
+                                 const CartDecomp& piece)
 {
     // coordset
     data["coordsets/coords/type"].set("uniform");
@@ -50,52 +70,84 @@ static void build_uniform3d_mesh(conduit_cpp::Node data,
     data["topologies/topo/type"].set("uniform");
     data["topologies/topo/coordset"].set("coords");
 
-    // // For multi-rank: specify the global whole extent so ParaView knows how pieces fit together
-    // if (size > 1) {
-    //     conduit_cpp::Node state = data["state"];
-    //     // Compute global extents assuming X is partitioned
-    //     const int global_nx = (size == 2 ? (nx - 1) * 2 + 1 : nx); // 2 ranks: 3 pts each, overlap 1 → 5 total
-    //     state["whole_extents/i"].append().set(0);
-    //     state["whole_extents/i"].append().set(global_nx - 1);
-    //     state["whole_extents/j"].append().set(0);
-    //     state["whole_extents/j"].append().set(ny - 1);
-    //     state["whole_extents/k"].append().set(0);
-    //     state["whole_extents/k"].append().set(nz - 1);
-        
-    //     // Piece extent for this rank
-    //     const int i_start = rank * (nx - 1);
-    //     const int i_end = i_start + (nx - 1);
-    //     state["extents/i"].append().set(i_start);
-    //     state["extents/i"].append().set(i_end);
-    //     state["extents/j"].append().set(0);
-    //     state["extents/j"].append().set(ny - 1);
-    //     state["extents/k"].append().set(0);
-    //     state["extents/k"].append().set(nz - 1);
-    // }
-
-    // one element-associated int field (external array provided)
-    const int ex = nx - 1;
-    const int ey = ny - 1;
-    const int ez = nz - 1;
-
-    conduit_cpp::Node fld = data["fields/f/values"];
-    fld.set_int32_ptr(const_cast<int32_t*>(vals_ptr), ncell);
-    data["fields/f/association"].set("element");
-    data["fields/f/topology"].set("topo");
+    // partition metadata: Blueprint logical origin of the piece (first cell, ghosts included)
+    // and the global / piece point extents, so the pieces assemble without merging
+    conduit_cpp::Node topo = data["topologies/topo"];
+    topo["elements/origin/i0"].set(piece.cell_begin[0]);
+    topo["elements/origin/j0"].set(piece.cell_begin[1]);
+    topo["elements/origin/k0"].set(piece.cell_begin[2]);
+
+    conduit_cpp::Node state = data["state"];
+    const char* axes[3] = {"i", "j", "k"};
+    for (int a = 0; a < 3; ++a) {
+        int64_t whole[2] = {0, piece.global_cells[a]};
+        int64_t extent[2] = {piece.cell_begin[a], piece.cell_begin[a] + piece.cell_count[a]};
+        state[std::string("whole_extents/") + axes[a]].set_int64_ptr(whole, 2);
+        state[std::string("extents/") + axes[a]].set_int64_ptr(extent, 2);
+    }
 }
 
 int main(int argc, char** argv)
 {
 
 
+    // --- Configuration (read first: the MPI thread level depends on --async) ---
+    MiniConfig cfg;
+    std::string cfg_error;
+    try {
+        cfg = MiniConfig::parse(argc, argv);
+    } catch (const std::exception& e) {
+        cfg_error = e.what();
+    }
+    AsyncPolicy async = cfg_error.empty() ? parse_async_policy(cfg.async) : AsyncPolicy::Off;
+
     // --- MPI init ---
     int rank = 0, size = 1;
 #if MINI_HAVE_MPI
-    MPI_Init(&argc, &argv);
+    const int provided = mini_mpi_init(&argc, &argv, async != AsyncPolicy::Off);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
+    if (async != AsyncPolicy::Off && provided < MPI_THREAD_MULTIPLE) {
+        if (rank == 0) std::cerr << "uniform_mini: MPI_THREAD_MULTIPLE not available, running in-situ synchronously\n";
+        async = AsyncPolicy::Off;
+    }
 #endif
 
+    // --- Decomposition ---
+    auto fail = [&](const std::string& msg) {
+        if (rank == 0) {
+            std::cerr << msg << "\n";
+            MiniConfig::usage(std::cerr, argv[0]);
+        }
+#if MINI_HAVE_MPI
+        MPI_Finalize();
+#endif
+        return 1;
+    };
+    if (!cfg_error.empty()) return fail(cfg_error);
+    CartDecomp decomp;
+    try {
+#if MINI_HAVE_MPI
+        decomp = cfg.cells_per_rank ? CartDecomp::create_weak(MPI_COMM_WORLD, cfg.cells)
+                                    : CartDecomp::create(MPI_COMM_WORLD, cfg.cells);
+#else
+        decomp = CartDecomp::serial(cfg.cells);
+#endif
+    } catch (const std::exception& e) {
+        return fail(e.what());
+    }
+    if (cfg.help) {
+        if (rank == 0) MiniConfig::usage(std::cout, argv[0]);
+#if MINI_HAVE_MPI
+        MPI_Finalize();
+#endif
+        return 0;
+    }
+    if (rank == 0) {
+        std::cout << "uniform_mini: " << cfg << " ranks=" << size << " (" << decomp.dims[0] << "x" << decomp.dims[1]
+                  << "x" << decomp.dims[2] << ")\n";
+    }
+
     // --- Catalyst initialize ---
     conduit_cpp::Node init;
 
@@ -115,13 +167,18 @@ int main(int argc, char** argv)
     init["catalyst/scripts/script/args"].append().set_string("uniform");
     init["catalyst/scripts/script/args"].append().set_string("--VTKextract");
     init["catalyst/scripts/script/args"].append().set_string("ON");
+    // the pieces carry extents and ghost cells: live view shows the partitioned data directly
+    init["catalyst/scripts/script/args"].append().set_string("--merge_blocks");
+    init["catalyst/scripts/script/args"].append().set_string("OFF");
 
         #if defined MINI_HAVE_MPI
+        if (!cfg.bench()) {
         MPI_Barrier(MPI_COMM_WORLD);
         if (rank==0)        init.print();
         MPI_Barrier(MPI_COMM_WORLD);
         if (rank==1)        init.print();
         MPI_Barrier(MPI_COMM_WORLD);
+        }
         #endif
 
     catalyst_status ierr = catalyst_initialize(conduit_cpp::c_node(&init));
@@ -142,47 +199,119 @@ int main(int argc, char** argv)
     
 
     // --- Simulation loop ---
-    const int steps = 20;
-    // Target: 4 elements (5 points) per dimension globally
-    const int pts_total = 5;
-    // Split X across 2 ranks: each gets 2 elements = 3 points; otherwise use full
-    const int nx = (size == 2 ? 3 : pts_total); // points per rank in X
-    const int ny = pts_total;                   // points per rank in Y
-    const int nz = pts_total;                   // points per rank in Z
+    const int steps = cfg.steps;
+    // Published piece: the owned block of the global grid plus --ghosts cell layers towards
+    // each neighbour (points = cells + 1; neighbouring pieces share a point plane)
+    const CartDecomp piece = decomp.ghosted(cfg.ghosts);
+    const int nx = static_cast<int>(piece.points(0));
+    const int ny = static_cast<int>(piece.points(1));
+    const int nz = static_cast<int>(piece.points(2));
     const double dx = 1.0, dy = 1.0, dz = 1.0;
     const double ox0 = 0.0, oy0 = 0.0, oz0 = 0.0;
 
-    const int ex = nx - 1, ey = ny - 1, ez = nz - 1;
-    const int64_t ncell = static_cast<int64_t>(ex) * ey * ez;
-    std::vector<int32_t> vals(static_cast<size_t>(ncell));
+    const int64_t ncell = piece.local_cells();
+    std::vector<std::vector<int32_t>> vals(static_cast<size_t>(cfg.fields), std::vector<int32_t>(static_cast<size_t>(ncell)));
+
+    // vtkGhostType: ghost cells are DUPLICATECELL, so the client skips them (and the faces
+    // between pieces) without merging; static, only published when there are ghosts
+    const bool has_ghosts = ncell != decomp.local_cells();
+    std::vector<uint8_t> ghost_types(has_ghosts ? static_cast<size_t>(ncell) : 0);
+    if (has_ghosts) fill_ghost_types(ghost_types, piece);
+
+    // each rank's origin is the global position of its first (possibly ghost) cell
+    const double ox = ox0 + static_cast<double>(piece.cell_begin[0]) * dx;
+    const double oy = oy0 + static_cast<double>(piece.cell_begin[1]) * dy;
+    const double oz = oz0 + static_cast<double>(piece.cell_begin[2]) * dz;
+
+    // channel (mesh): built once, the mesh is static; element-associated int fields
+    // "f", "f1", ... reference `fv` (external arrays)
+    auto make_channel = [&](std::vector<std::vector<int32_t>>& fv) {
+        auto channel = std::make_unique<PersistentChannel>("uniform");
+        // channel->exec()["catalyst/channels/uniform/state/multiblock"].set(1); // let PV treat ranks as partitions // breaks vtpd extraction
+        build_uniform3d_mesh(channel->data(), nx, ny, nz, ox, oy, oz, dx, dy, dz, piece);
+        if (has_ghosts) {
+            conduit_cpp::Node ghost = channel->data()["fields/vtkGhostType"];
+            ghost["association"].set("element");
+            ghost["topology"].set("topo");
+            set_external_values(ghost["values"], ghost_types.data(), ncell);
+        }
+        for (int f = 0; f < cfg.fields; ++f) {
+            const std::string name = f == 0 ? "f" : "f" + std::to_string(f);
+            channel->add_field(name, "element", "topo", fv[static_cast<size_t>(f)].data(), ncell);
+        }
+        return channel;
+    };
+
+    // synchronous: one channel on the simulation's own arrays; async: one channel per
+    // buffer slot, executed by the in-situ thread
+    std::vector<std::vector<std::vector<int32_t>>> slot_vals;
+    std::vector<std::unique_ptr<PersistentChannel>> channels;
+    std::unique_ptr<AsyncInSitu> insitu;
+    if (async == AsyncPolicy::Off) {
+        channels.push_back(make_channel(vals));
+    } else {
+        slot_vals.assign(2, vals);
+        for (auto& fv : slot_vals) channels.push_back(make_channel(fv));
+        insitu = std::make_unique<AsyncInSitu>(2, async, [&channels](int slot) {
+            return catalyst_execute(channels[static_cast<size_t>(slot)]->c_exec()) == catalyst_status_ok;
+        });
+    }
+
+    // full verification on the first step and on schema changes (MINI_VERIFY=always: every step)
+    BlueprintVerifier verifier("mesh");
 
-    for (int step = 0; step < steps; ++step) {
-        conduit_cpp::Node exec;
+    // per-phase timings (reported with --csv) and the optional synthetic compute kernel
+    PhaseLog phases(steps);
+    std::optional<SyntheticKernel> kernel;
+    if (cfg.work > 0) kernel.emplace(decomp);
+    TriggerController trigger(cfg.budget, cfg.must_fire, cfg.trigger_log);
 
-        // state
-        exec["catalyst/state/cycle"].set(step);
-        exec["catalyst/state/time"].set(static_cast<double>(step));
-        exec["catalyst/state/domain_id"].set(rank);
+    const auto t_loop = PhaseLog::now();
+    for (int step = 0; step < steps; ++step) {
+        const auto t_step = PhaseLog::now();
 
-        // channel (mesh)
-        conduit_cpp::Node ch = exec["catalyst/channels/uniform"];
-        ch["type"].set("mesh");
-        // ch["state/multiblock"].set(1); // let PV treat ranks as partitions // breaks vtpd extraction
+        auto t0 = PhaseLog::now();
+        if (kernel) kernel->run(cfg.work);
+        phases.add(step, Phase::Compute, PhaseLog::since(t0));
 
         // Prepare field values (alternate order per step)
-        if (step % 2 == 0) {
-            for (int64_t i = 0; i < ncell; ++i) vals[static_cast<size_t>(i)] = static_cast<int32_t>(i + step);
-        } else {
-            for (int64_t i = 0; i < ncell; ++i) vals[static_cast<size_t>(i)] = static_cast<int32_t>((ncell - 1 - i) + step);
+        t0 = PhaseLog::now();
+        // (ghost cells follow the same global pattern; a real code fills them by halo exchange)
+        for (int f = 0; f < cfg.fields; ++f) fill_cell_values(vals[static_cast<size_t>(f)], piece, step, f);
+        phases.add(step, Phase::FieldUpdate, PhaseLog::since(t0));
+
+        // in situ this step? (trigger: same answer on all ranks); async: claim a buffer
+        // slot (blocks, or -1 when the frame is dropped on all ranks)
+        t0 = PhaseLog::now();
+        const int slot = !trigger.fire(step) ? -1 : (insitu ? insitu->acquire() : 0);
+        const double t_acquire = PhaseLog::since(t0);
+        if (slot < 0) {
+            phases.add(step, Phase::Execute, t_acquire);
+            if (cfg.sleep > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(cfg.sleep));
+            const double t = PhaseLog::since(t_step);
+            phases.add(step, Phase::Step, t);
+            trigger.end_step(step, t, t_acquire);
+            continue;
         }
+        PersistentChannel& channel = *channels[static_cast<size_t>(slot)];
 
-    // tile ranks along X so each rank shows a distinct partition
-    const double ox = ox0 + rank * (nx - 1) * dx;
-        build_uniform3d_mesh(ch["data"], nx, ny, nz, ox, oy0, oz0, dx, dy, dz, vals.data(), ncell, rank, size);
+        // state + field pointers (async: copy the step's values into the slot first)
+        t0 = PhaseLog::now();
+        auto& fv = insitu ? slot_vals[static_cast<size_t>(slot)] : vals;
+        if (insitu) {
+            for (int f = 0; f < cfg.fields; ++f) fv[static_cast<size_t>(f)] = vals[static_cast<size_t>(f)];
+        }
+        channel.set_state(step, static_cast<double>(step), rank);
+        for (int f = 0; f < cfg.fields; ++f) {
+            channel.set_field(static_cast<std::size_t>(f), fv[static_cast<size_t>(f)].data(), ncell);
+        }
+        phases.add(step, Phase::NodeBuild, PhaseLog::since(t0));
 
         // Verify the mesh using Conduit's mesh blueprint verification
+        t0 = PhaseLog::now();
         conduit_cpp::Node verify_info;
-        bool is_valid = conduit_cpp::Blueprint::verify("mesh", ch["data"], verify_info);
+        bool is_valid = verifier.check(channel.data(), verify_info);
+        phases.add(step, Phase::Verify, PhaseLog::since(t0));
         if (!is_valid) {
             std::cerr << "[Rank " << rank << "] Mesh blueprint verification FAILED at step " << step << ":\n";
             verify_info.print();
@@ -191,29 +320,51 @@ int main(int argc, char** argv)
 #else
             return 3;
 #endif
-        } else if (step == 0) {
+        } else if (step == 0 || (verifier.last_was_full() && verifier.mode() == BlueprintVerifier::Mode::Once)) {
+            // first step, or re-verified after a schema change
             std::cout << "[Rank " << rank << "] Mesh blueprint verification PASSED at step " << step << "\n";
         }
 
-        if(step==0){
+        if(step==0 && ncell <= 1024 && !cfg.bench()){  // tree print includes the arrays: small meshes only
         #if defined MINI_HAVE_MPI
         MPI_Barrier(MPI_COMM_WORLD);
-        if (rank==0)        exec.print();
+        if (rank==0)        channel.exec().print();
         MPI_Barrier(MPI_COMM_WORLD);
-        if (rank==1)        exec.print();
+        if (rank==1)        channel.exec().print();
         MPI_Barrier(MPI_COMM_WORLD);
         #endif
         }
 
-        ierr = catalyst_execute(conduit_cpp::c_node(&exec));
+        // execute, or hand the slot to the in-situ thread (Execute: time the simulation stalls)
+        t0 = PhaseLog::now();
+        if (insitu) {
+            insitu->publish(slot);
+            ierr = insitu->failures() ? catalyst_status_error_incomplete : catalyst_status_ok;
+        } else {
+            ierr = catalyst_execute(channel.c_exec());
+        }
+        phases.add(step, Phase::Execute, t_acquire + PhaseLog::since(t0));
         if (ierr != catalyst_status_ok) {
             std::cerr << "catalyst_execute failed (step=" << step << ") code " << static_cast<int>(ierr) << "\n";
             break;
         }
 
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (cfg.sleep > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(cfg.sleep));
+        const double t = PhaseLog::since(t_step);
+        phases.add(step, Phase::Step, t);
+        trigger.end_step(step, t, phases.get(step, Phase::NodeBuild) + phases.get(step, Phase::Verify) +
+                                      phases.get(step, Phase::Execute));
     }
 
+    const double loop_wall = PhaseLog::since(t_loop);
+    const auto t_drain = PhaseLog::now();
+    if (insitu) insitu->finish();
+    report_throughput("uniform_mini", steps, loop_wall, PhaseLog::since(t_drain), insitu.get());
+    trigger.report("uniform_mini", steps);
+    if (kernel) kernel->report("uniform_mini");
+
+    if (cfg.bench()) phases.write_csv(cfg.csv, "uniform_mini", cfg, decomp);
+
     // --- Finalize ---
     conduit_cpp::Node fin;
     ierr = catalyst_finalize(conduit_cpp::c_node(&fin));
@@ -221,7 +372,9 @@ int main(int argc, char** argv)
         std::cerr << "catalyst_finalize failed with code " << static_cast<int>(ierr) << "\n";
     }
 
+    trigger.free();
 #if MINI_HAVE_MPI
+    decomp.free();
     MPI_Finalize();
 #endif
     return 0;